@@ -0,0 +1,164 @@
+/*
+  PsychoPlug
+  ESP8266 based remote outlet with standalone timer and MQTT integration
+  
+  Copyright (C) 2017  Earle F. Philhower, III
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <Arduino.h>
+#include <TimeLib.h>
+
+#include "psychoplug.h"
+#include "api.h"
+#include "web.h"
+#include "settings.h"
+#include "schedule.h"
+#include "relay.h"
+#include "timezone.h"
+#include "log.h"
+
+// Short, URL friendly action names, indexed by ACTION_xxx
+static const char apiActions[ACTION_MAX+1][9] PROGMEM = { "none", "on", "off", "toggle", "pulseoff", "pulseon", "onfor" };
+
+static int ParseAction(const char *str)
+{
+  for (int i=0; i<=ACTION_MAX; i++) {
+    if (!strcmp_P(str, apiActions[i])) return i;
+  }
+  return -1;
+}
+
+void APIError(WebWriter *out, int code)
+{
+  WebJSONHeaders(out, code);
+  WebPrintf(out, "{\"error\":%d}", code);
+}
+
+void APIGetState(WebWriter *out, char *url, char *params)
+{
+  time_t t = now();
+  WebJSONHeaders(out, 200);
+  WebPrintf(out, "{\"power\":%d,\"uptime\":%lu,\"time\":%lu,\"local\":%lu,\"ntp\":%d,\"timer\":%ld}", GetRelay()?1:0, millis()/1000,
+            (unsigned long)t, (unsigned long)LocalTime(t), (timeStatus()!=timeNotSet)?1:0, RelayTimeLeft());
+}
+
+static void PrintAPIEvent(WebWriter *out, int id, const Event *e)
+{
+  char str[16];
+  strcpy_P(str, apiActions[(e->action <= ACTION_MAX) ? e->action : ACTION_NONE]);
+  WebPrintf(out, "[%d,%d,%d,%d,\"%s\"]", id, e->dayMask, e->hour, e->minute, str);
+}
+
+void APIGetSchedule(WebWriter *out, char *url, char *params)
+{
+  if (WebNotModified(out, SettingsGeneration())) return;
+  WebJSONHeaders(out, 200);
+  WebPrintf(out, "{\"events\":[");
+  for (int i=0; i<EventCount(); i++) {
+    if (i) out->write(',');
+    PrintAPIEvent(out, i, GetEvent(i));
+  }
+  WebPrintf(out, "],\"max\":%d}", MAXEVENTS);
+}
+
+void APIGetSettings(WebWriter *out, char *url, char *params)
+{
+  char ip[16];
+  if (WebNotModified(out, SettingsGeneration())) return;
+  WebJSONHeaders(out, 200);
+  WebPrintf(out, "{\"hostname\":");
+  WebJSONString(out, settings.hostname);
+  WebPrintf(out, ",\"ssid\":");
+  WebJSONString(out, settings.ssid);
+  WebPrintf(out, ",\"dhcp\":%d", settings.useDHCP?1:0);
+  snprintf_P(ip, sizeof(ip), PSTR("%d.%d.%d.%d"), settings.ip[0], settings.ip[1], settings.ip[2], settings.ip[3]);
+  WebPrintf(out, ",\"ip\":\"%s\"", ip);
+  snprintf_P(ip, sizeof(ip), PSTR("%d.%d.%d.%d"), settings.netmask[0], settings.netmask[1], settings.netmask[2], settings.netmask[3]);
+  WebPrintf(out, ",\"netmask\":\"%s\"", ip);
+  snprintf_P(ip, sizeof(ip), PSTR("%d.%d.%d.%d"), settings.gateway[0], settings.gateway[1], settings.gateway[2], settings.gateway[3]);
+  WebPrintf(out, ",\"gateway\":\"%s\"", ip);
+  snprintf_P(ip, sizeof(ip), PSTR("%d.%d.%d.%d"), settings.dns[0], settings.dns[1], settings.dns[2], settings.dns[3]);
+  WebPrintf(out, ",\"dns\":\"%s\"", ip);
+  snprintf_P(ip, sizeof(ip), PSTR("%d.%d.%d.%d"), settings.logsvr[0], settings.logsvr[1], settings.logsvr[2], settings.logsvr[3]);
+  WebPrintf(out, ",\"logsvr\":\"%s\",\"ntp\":", ip);
+  WebJSONString(out, settings.ntp);
+  WebPrintf(out, ",\"timezone\":");
+  WebJSONString(out, settings.timezone);
+  WebPrintf(out, ",\"use12hr\":%d,\"usedmy\":%d,\"onafterpfail\":%d", settings.use12hr?1:0, settings.usedmy?1:0, settings.onAfterPFail?1:0);
+  WebPrintf(out, ",\"mqtt\":{\"enable\":%d,\"host\":", settings.mqttEnable?1:0);
+  WebJSONString(out, settings.mqttHost);
+  WebPrintf(out, ",\"port\":%d,\"ssl\":%d,\"clientid\":", settings.mqttPort, settings.mqttSSL?1:0);
+  WebJSONString(out, settings.mqttClientID);
+  WebPrintf(out, ",\"topic\":");
+  WebJSONString(out, settings.mqttTopic);
+  WebPrintf(out, ",\"user\":");
+  WebJSONString(out, settings.mqttUser);
+  WebPrintf(out, "},\"uiuser\":");
+  WebJSONString(out, settings.uiUser);
+  WebPrintf(out, "}");
+}
+
+void APIPostAction(WebWriter *out, char *url, char *params)
+{
+  char *namePtr;
+  char *valPtr;
+  int action = -1;
+  int ms = 0;
+  int mins = 0;
+  while (ParseParam(&params, &namePtr, &valPtr)) {
+    if (!strcmp_P(namePtr, PSTR("action"))) action = ParseAction(valPtr);
+    ParamInt("ms", ms);
+    ParamInt("minutes", mins);
+  }
+  if (action < 0 || ms < 0 || mins < 0 || mins > 24 * 60) {
+    APIError(out, 400);
+  } else {
+    PerformAction(action, mins ? mins * 60000UL : (unsigned long)ms);
+    APIGetState(out, NULL, NULL);
+  }
+}
+
+void APIPostSchedule(WebWriter *out, char *url, char *params)
+{
+  char *namePtr;
+  char *valPtr;
+
+  // Any of these not given, error
+  int id = -1;
+  int days = -1;
+  int hr = -1;
+  int mn = -1;
+  int action = -1;
+  while (ParseParam(&params, &namePtr, &valPtr)) {
+    ParamInt("id", id);
+    ParamInt("days", days);
+    ParamInt("hour", hr);
+    ParamInt("minute", mn);
+    if (!strcmp_P(namePtr, PSTR("action"))) action = ParseAction(valPtr);
+  }
+  if (id < 0 || id > EventCount() || days < 0 || days > 127 || hr < 0 || hr > 23 || mn < 0 || mn > 59 || action < 0) {
+    APIError(out, 400);
+    return;
+  }
+  Event e = { (byte)days, (byte)hr, (byte)mn, (byte)action };
+  if (!SetEvent(id, &e)) {
+    APIError(out, 507); // Full
+    return;
+  }
+  SaveSettings();
+  WebJSONHeaders(out, 200);
+  PrintAPIEvent(out, id, &e);
+}
@@ -0,0 +1,42 @@
+/*
+  PsychoPlug
+  ESP8266 based remote outlet with standalone timer and MQTT integration
+  
+  Copyright (C) 2017  Earle F. Philhower, III
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _api_h
+#define _api_h
+
+#include "web.h"
+
+// JSON REST interface under https://<plug>/api/v1/, same authentication as the web UI
+//   GET  state              {"power":1,"uptime":secs,"time":utc,"local":localtime,"ntp":1,"timer":ms}, timer -1 if none running
+//   GET  schedule           {"events":[[id,daymask,hour,minute,"action"],...],"max":MAXEVENTS}, ids run from 0 with no gaps
+//   GET  settings           Configuration, less any passwords
+//   POST action             action=on|off|toggle|pulseon|pulseoff|onfor, optional ms= or minutes= (up to a day), returns state
+//   POST schedule           id=, days=(bitmask, Sun=1), hour=(0-23), minute=, action=, returns the event.
+//                           id=<count> adds an event, action=none deletes one, 507 when full
+// Errors come back as {"error":code} with the matching HTTP status
+// Route handlers, see the table in psychoplug.ino
+void APIGetState(WebWriter *out, char *url, char *params);
+void APIGetSchedule(WebWriter *out, char *url, char *params);
+void APIGetSettings(WebWriter *out, char *url, char *params);
+void APIPostAction(WebWriter *out, char *url, char *params);
+void APIPostSchedule(WebWriter *out, char *url, char *params);
+void APIError(WebWriter *out, int code);
+
+#endif
@@ -0,0 +1,65 @@
+#!/bin/bash
+
+# Compare the server-side TLS handshake cost of the certificate types that
+# make-certs-256.sh can generate.  Runs entirely on the host with OpenSSL:
+# a local s_server is hammered with full (non-resumed) handshakes from s_time
+# and the server's CPU time is divided by the number of connections made.
+# Absolute times are for this machine, the ratio is what matters for the plug.
+# Usage: bash bench-certs.sh [seconds-per-test]
+
+SECS=${1:-5}
+PORT=44330
+TMP=$(mktemp -d)
+trap "rm -rf $TMP" EXIT
+cd $TMP
+
+cat > certs.conf <<EOF
+[ req ]
+distinguished_name = req_distinguished_name
+prompt = no
+
+[ req_distinguished_name ]
+O = psychoplug
+CN = 127.0.0.1
+EOF
+
+# Self-signed certificate of the given type, named after it
+makecert() {
+  case $1 in
+    rsa*) openssl genrsa -out $1.key ${1#rsa} 2>/dev/null ;;
+    ec256) openssl ecparam -name prime256v1 -genkey -noout -out $1.key ;;
+  esac
+  openssl req -x509 -new -key $1.key -out $1.pem -sha256 -days 1 -config certs.conf 2>/dev/null
+}
+
+# Server CPU ticks (user+system) for a PID
+cputicks() {
+  awk '{print $14 + $15}' /proc/$1/stat
+}
+
+bench() {
+  local name=$1 cipher=$2
+  makecert $name
+  openssl s_server -quiet -accept $PORT -cert $name.pem -key $name.key -no_tls1_3 \
+    -cipher "$cipher:@SECLEVEL=0" -www > /dev/null 2>&1 &
+  local pid=$!
+  sleep 1
+  local before=$(cputicks $pid)
+  local conns=$(openssl s_time -connect 127.0.0.1:$PORT -new -time $SECS -cipher "$cipher:@SECLEVEL=0" 2>/dev/null | \
+    awk '/connections in/ {print $1; exit}')
+  local after=$(cputicks $pid)
+  kill $pid
+  wait $pid 2>/dev/null
+  local hz=$(getconf CLK_TCK)
+  awk -v n="$name" -v c="$conns" -v t=$((after - before)) -v hz=$hz \
+    'BEGIN { if (c > 0) printf("%-8s %6d handshakes, %8.1f us server CPU per handshake\n", n, c, (t / hz) * 1e6 / c); else printf("%-8s failed\n", n); }'
+}
+
+# Same ECDHE key exchange and bulk cipher, only the certificate differs
+bench rsa512  ECDHE-RSA-AES128-GCM-SHA256
+bench rsa1024 ECDHE-RSA-AES128-GCM-SHA256
+bench rsa2048 ECDHE-RSA-AES128-GCM-SHA256
+bench ec256   ECDHE-ECDSA-AES128-GCM-SHA256
+
+# Raw private key operations, what the plug does once per full handshake
+openssl speed -seconds $SECS rsa512 rsa1024 rsa2048 ecdsap256 2>/dev/null | grep -E "^(rsa|[ ]*256 bits ecdsa)|sign "
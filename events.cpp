@@ -0,0 +1,122 @@
+/*
+  PsychoPlug
+  ESP8266 based remote outlet with standalone timer and MQTT integration
+  
+  Copyright (C) 2017  Earle F. Philhower, III
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+
+#include "psychoplug.h"
+#include "events.h"
+#include "web.h"
+#include "relay.h"
+#include "log.h"
+
+// Clients are owned by their web connection slot, we only write to them
+static WiFiClient *subscribers[EVENTS_MAX_SUBSCRIBERS];
+static unsigned long lastHeartbeat = 0;
+
+
+// Send one SSE message to a subscriber.  A failed write means it went away,
+// so hang up and let the connection slot notice and clean up.
+static void EventsSend(WiFiClient *client, const char *msg, int len)
+{
+  if (client->write((const uint8_t *)msg, len) != (size_t)len) {
+    LogPrintf("Events: Write failed, dropping subscriber\n");
+    client->stop();
+  }
+}
+
+bool EventsSubscribe(WebWriter *out)
+{
+  int slot = -1;
+  for (int i=0; i<EVENTS_MAX_SUBSCRIBERS; i++) {
+    if (!subscribers[i]) { slot = i; break; }
+  }
+  if (slot < 0) {
+    out->setKeepAlive(false);
+    WebError(out, 503, PSTR("Retry-After: 60"));
+    return false;
+  }
+
+  // The stream runs until the client hangs up, so no chunking or keep-alive
+  out->setKeepAlive(false);
+  WebPrintf(out, "HTTP/1.1 200 OK\r\n");
+  WebPrintf(out, "Server: PsychoPlug\r\n");
+  WebPrintf(out, "Content-type: text/event-stream\r\n");
+  WebPrintf(out, "Cache-Control: no-cache\r\n");
+  WebPrintf(out, "Connection: close\r\n");
+  WebPrintf(out, "\r\n");
+  out->beginBody();
+  // Start them off with the current state
+  WebPrintf(out, "retry: 5000\n\nevent: powerstate\ndata: %d\n\n", GetRelay()?1:0);
+  out->end();
+
+  subscribers[slot] = out->client();
+  LogPrintf("Events: Subscriber %d added\n", slot);
+  return true;
+}
+
+void EventsUnsubscribe(WiFiClient *client)
+{
+  for (int i=0; i<EVENTS_MAX_SUBSCRIBERS; i++) {
+    if (subscribers[i] == client) {
+      subscribers[i] = NULL;
+      LogPrintf("Events: Subscriber %d removed\n", i);
+    }
+  }
+}
+
+bool EventsSubscribed(WiFiClient *client)
+{
+  for (int i=0; i<EVENTS_MAX_SUBSCRIBERS; i++) {
+    if (subscribers[i] == client) return true;
+  }
+  return false;
+}
+
+void ManageEvents()
+{
+  if (millis() - lastHeartbeat < EVENTS_HEARTBEAT_MS) return;
+  lastHeartbeat = millis();
+
+  static const char ping[] = ": ping\n\n";
+  for (int i=0; i<EVENTS_MAX_SUBSCRIBERS; i++) {
+    if (subscribers[i]) EventsSend(subscribers[i], ping, sizeof(ping) - 1);
+  }
+}
+
+void EventsPublish(const char *key, const char *value)
+{
+  char msg[96];
+  int len = -1;
+  for (int i=0; i<EVENTS_MAX_SUBSCRIBERS; i++) {
+    if (!subscribers[i]) continue;
+    if (len < 0) {
+      // Only format when someone's listening
+      len = snprintf_P(msg, sizeof(msg), PSTR("event: %s\ndata: %s\n\n"), key, value);
+      if (len >= (int)sizeof(msg)) {
+        // Cut off it would lose the blank line ending it and run into the next one
+        LogPrintf("Events: '%s' too long, not sent\n", key);
+        break;
+      }
+    }
+    EventsSend(subscribers[i], msg, len);
+  }
+  lastHeartbeat = millis(); // Any traffic counts as a heartbeat
+}
@@ -0,0 +1,37 @@
+/*
+  PsychoPlug
+  ESP8266 based remote outlet with standalone timer and MQTT integration
+  
+  Copyright (C) 2017  Earle F. Philhower, III
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _events_h
+#define _events_h
+
+#include <ESP8266WiFi.h>
+#include "web.h"
+
+// Server-Sent Events push of the same state changes published over MQTT
+#define EVENTS_MAX_SUBSCRIBERS (2)
+#define EVENTS_HEARTBEAT_MS (15000) // Keep idle streams (and any proxies) from timing out
+
+bool EventsSubscribe(WebWriter *out); // Answer a GET of /events and add the client, false if full
+void EventsUnsubscribe(WiFiClient *client);
+bool EventsSubscribed(WiFiClient *client);
+void ManageEvents(); // Heartbeats
+void EventsPublish(const char *key, const char *value); // Send "event: key / data: value" to all subscribers
+
+#endif
@@ -0,0 +1,432 @@
+/*
+  PsychoPlug
+  ESP8266 based remote outlet with standalone timer and MQTT integration
+  
+  Copyright (C) 2017  Earle F. Philhower, III
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Form and URL decoding.  Build a host test and benchmark with:
+//   g++ -DTEST_WEB -O2 -o formtest form.cpp && ./formtest
+
+#ifndef TEST_WEB
+#include <Arduino.h>
+#else
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+typedef uint8_t byte;
+#endif
+#include "form.h"
+
+
+// In-place decoder, overwrites source with decoded values.  Needs 0-termination on input
+// Try and keep memory needs low, speed not critical
+static uint8_t b64lut(uint8_t i)
+{
+  if (i >= 'A' && i <= 'Z') return i - 'A';
+  if (i >= 'a' && i <= 'z') return i - 'a' + 26;
+  if (i >= '0' && i <= '9') return i - '0' + 52;
+  if (i == '-') return 62;
+  if (i == '_') return 63;
+  else return 64;// sentinel
+}
+
+void Base64Decode(char *str)
+{
+  char *dest;
+  dest = str;
+
+  if (strlen(str)%4) return; // Not multiple of 4 == error
+  
+  while (*str) {
+    uint8_t a = b64lut(*(str++));
+    uint8_t b = b64lut(*(str++));
+    uint8_t c = b64lut(*(str++));
+    uint8_t d = b64lut(*(str++));
+    *(dest++) = (a << 2) | ((b & 0x30) >> 4);
+    if (c == 64) break;
+    *(dest++) = ((b & 0x0f) << 4) | ((c & 0x3c) >> 2);
+    if (d == 64) break;
+    *(dest++) = ((c & 0x03) << 6) | d;
+  }
+  *dest = 0; // Terminate the string
+}
+
+
+static int HexDigit(char c)
+{
+  if (c>='0' && c<='9') return c - '0';
+  if (c>='a' && c<='f') return c - 'a' + 10;
+  if (c>='A' && c<='F') return c - 'A' + 10;
+  return -1;
+}
+
+// Decode in place until the end of the string or either stop character, with a
+// read cursor running ahead of the write cursor so each byte is touched once.
+// The decoded span is 0-terminated and *next is set just past the stop character.
+// Bad % escapes are passed through unchanged.
+static char URLDecodeSpan(char *str, char stop1, char stop2, char **next)
+{
+  char *rd = str;
+  char *wr = str;
+  while (*rd && *rd != stop1 && *rd != stop2) {
+    int hi, lo;
+    if (*rd == '+') {
+      *(wr++) = ' ';
+      rd++;
+    } else if (*rd == '%' && (hi = HexDigit(rd[1])) >= 0 && (lo = HexDigit(rd[2])) >= 0) {
+      *(wr++) = (hi << 4) | lo;
+      rd += 3;
+    } else {
+      *(wr++) = *(rd++);
+    }
+  }
+  char stop = *rd;
+  *wr = 0; // May overwrite the stop char, which is why it was saved
+  *next = stop ? rd + 1 : rd;
+  return stop;
+}
+
+void URLDecode(char *ptr)
+{
+  char *end;
+  URLDecodeSpan(ptr, 0, 0, &end);
+}
+
+
+// Scan out and update a pointer into the param string, returning the name and value or false if done.
+// Splitting happens before decoding, so an encoded & or = stays part of the name or value.
+bool ParseParam(char **paramStr, char **name, char **value)
+{
+  char *data = *paramStr;
+ 
+  while (*data == '&') data++; // Empty pairs carry nothing
+  if (*data==0) return false;
+
+  *name = data;
+  char *end = data;
+  if (URLDecodeSpan(data, '=', '&', &data) == '=') {
+    *value = data;
+    URLDecodeSpan(data, '&', 0, &data);
+  } else {
+    // No value given, point at the name's terminator for an empty string
+    while (*end) end++;
+    *value = end;
+  }
+
+  *paramStr = data;
+  return true;
+}
+
+
+void FormBegin(FormParser *form, char *buff, int size, FormHandler handler)
+{
+  form->buff = buff;
+  form->size = size;
+  form->len = 0;
+  form->fields = 0;
+  form->overflow = false;
+  form->dropped = 0;
+  form->handler = handler;
+}
+
+// Decode and hand out the field in the buffer
+static void FormField(FormParser *form)
+{
+  if (form->overflow) {
+    form->dropped++;
+  } else if (form->len) {
+    form->buff[form->len] = 0;
+    char *p = form->buff;
+    char *name, *value;
+    ParseParam(&p, &name, &value);
+    if (!form->fields) form->handler(NULL, NULL);
+    form->handler(name, value);
+    form->fields++;
+  }
+  form->len = 0;
+  form->overflow = false;
+}
+
+void FormFeed(FormParser *form, const char *data, int len)
+{
+  while (len > 0) {
+    const char *amp = (const char *)memchr(data, '&', len);
+    int chunk = amp ? amp - data : len;
+    if (form->len + chunk < form->size) {
+      memcpy(form->buff + form->len, data, chunk);
+      form->len += chunk;
+    } else {
+      form->overflow = true;
+    }
+    if (!amp) break;
+    FormField(form);
+    data += chunk + 1;
+    len -= chunk + 1;
+  }
+}
+
+void FormEnd(FormParser *form)
+{
+  FormField(form);
+}
+
+
+// Scan an integer from a string, place it into dest, and then return # of bytes scanned
+int ParseInt(char *src, int *dest)
+{
+  byte count = 0;
+  bool neg = false;
+  int res = 0;
+  if (!src) return 0;
+  if (src[0] == '-') {neg = true; src++; count++;}
+  while (*src && (*src>='0') && (*src<='9')) {
+    res = res * 10;
+    res += *src - '0';
+    src++;
+    count++;
+  }
+  if (neg) res *= -1;
+  if (dest) *dest = res;
+  return count;
+}
+
+void Read4Int(char *str, byte *p)
+{
+  int i = 0;
+  str += ParseInt(str, &i); p[0] = i; if (*str) str++;
+  str += ParseInt(str, &i); p[1] = i; if (*str) str++;
+  str += ParseInt(str, &i); p[2] = i; if (*str) str++;
+  str += ParseInt(str, &i); p[3] = i;
+}
+
+
+#if defined(TEST_WEB) && !defined(TEST_SETUP) // Which has its own main()
+// The original decoder, which shifted the rest of the string down for every escape
+static void OldURLDecode(char *ptr)
+{
+  while (*ptr) {
+    if (*ptr == '+') {
+      *ptr = ' ';
+    } else if (*ptr == '%') {
+      if (*(ptr+1) && *(ptr+2)) {
+        byte a = *(ptr + 1);
+        byte b = *(ptr + 2);
+        if (a>='0' && a<='9') a -= '0';
+        else if (a>='a' && a<='f') a = a - 'a' + 10;
+        else if (a>='A' && a<='F') a = a - 'A' + 10;
+        if (b>='0' && b<='9') b -= '0';
+        else if (b>='a' && b<='f') b = b - 'a' + 10;
+        else if (b>='A' && b<='F') b = b - 'A' + 10;
+        *ptr = ((a&0x0f)<<4) | (b&0x0f);
+        // Safe strcpy the rest of the string back
+        char *p1 = ptr + 1;
+        char *p2 = ptr + 3;
+        while (*p2) { *p1 = *p2; p1++; p2++; }
+        *p1 = 0;
+      }
+    }
+    ptr++;
+  }
+}
+
+// And the original splitter, run after decoding the whole string
+static bool OldParseParam(char **paramStr, char **name, char **value)
+{
+  char *data = *paramStr;
+  if (*data==0) return false;
+  char *namePtr = data;
+  while ((*data != 0) && (*data != '=') && (*data != '&')) data++;
+  if (*data) { *data = 0; data++; }
+  char *valPtr = data;
+  if  (*data == '=') data++;
+  while ((*data != 0) && (*data != '=') && (*data != '&')) data++;
+  if (*data) { *data = 0; data++;}
+  *paramStr = data;
+  *name = namePtr;
+  *value = valPtr;
+  return true;
+}
+
+static int failures = 0;
+
+static void Check(const char *what, const char *in, const char *got, const char *want)
+{
+  if (strcmp(got, want)) {
+    printf("FAIL %s '%s': got '%s', want '%s'\n", what, in, got, want);
+    failures++;
+  }
+}
+
+// Streaming parser output, rendered like Pairs() below
+static char formOut[4096];
+static void FormCollect(char *name, char *value)
+{
+  if (name) sprintf(formOut + strlen(formOut), "%s:%s|", name, value);
+}
+
+// Run ParseParam over a string and render the result as "name:value|name:value|"
+static void Pairs(const char *in, char *out)
+{
+  char buff[256];
+  strcpy(buff, in);
+  char *p = buff;
+  char *n, *v;
+  *out = 0;
+  while (ParseParam(&p, &n, &v)) {
+    out += sprintf(out, "%s:%s|", n, v);
+  }
+}
+
+static void FormCount(char * /*name*/, char * /*value*/)
+{
+}
+
+static double Now()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Time old (decode everything, then split) vs. new (split and decode in one pass)
+static void Bench(const char *name, const char *pattern, int reps)
+{
+  int len = strlen(pattern) * reps;
+  char *src = (char *)malloc(len + 1);
+  char *buff = (char *)malloc(len + 1);
+  src[0] = 0;
+  for (int i=0; i<reps; i++) strcat(src, pattern);
+
+  char *n, *v;
+  strcpy(buff, src);
+  double t0 = Now();
+  OldURLDecode(buff);
+  char *p = buff;
+  int oldPairs = 0;
+  while (OldParseParam(&p, &n, &v)) oldPairs++;
+  double t1 = Now();
+  strcpy(buff, src);
+  double t2 = Now();
+  p = buff;
+  int newPairs = 0;
+  while (ParseParam(&p, &n, &v)) newPairs++;
+  double t3 = Now();
+  printf("%-24s %7d bytes: old %10.3f ms (%d pairs), new %8.3f ms (%d pairs)\n", name, len, (t1-t0)*1e3, oldPairs, (t3-t2)*1e3, newPairs);
+  free(src);
+  free(buff);
+}
+
+int main()
+{
+  static const char *decodes[][2] = {
+    { "", "" }, { "abc", "abc" }, { "a+b", "a b" }, { "%41%42%43", "ABC" }, { "%4a%4A", "JJ" },
+    { "100%", "100%" }, { "%4", "%4" }, { "%zz", "%zz" }, { "%%41", "%A" }, { "%2541", "%41" },
+    { "+%2B+", " + " }, { "a%00b", "a" },
+  };
+  for (unsigned i=0; i<sizeof(decodes)/sizeof(decodes[0]); i++) {
+    char buff[64];
+    strcpy(buff, decodes[i][0]);
+    URLDecode(buff);
+    Check("URLDecode", decodes[i][0], buff, decodes[i][1]);
+  }
+
+  static const char *pairs[][2] = {
+    { "", "" }, { "a=1", "a:1|" }, { "a=1&b=2", "a:1|b:2|" }, { "a", "a:|" }, { "a&b=2", "a:|b:2|" },
+    { "a=", "a:|" }, { "=1", ":1|" }, { "a=1&", "a:1|" }, { "a=1&&b=2", "a:1|b:2|" },
+    { "p%3Dq=x%26y", "p=q:x&y|" }, { "k=a=b", "k:a=b|" }, { "ssid=My+Net%21&pass=%25%25", "ssid:My Net!|pass:%%|" },
+  };
+  for (unsigned i=0; i<sizeof(pairs)/sizeof(pairs[0]); i++) {
+    char out[256];
+    Pairs(pairs[i][0], out);
+    Check("ParseParam", pairs[i][0], out, pairs[i][1]);
+  }
+
+  // The streaming parser must split the same way whatever size pieces the body arrives in
+  for (unsigned i=0; i<sizeof(pairs)/sizeof(pairs[0]); i++) {
+    for (int piece=1; piece<=8; piece++) {
+      char field[64];
+      FormParser form;
+      formOut[0] = 0;
+      FormBegin(&form, field, sizeof(field), FormCollect);
+      const char *in = pairs[i][0];
+      for (int j=0; j<(int)strlen(in); j+=piece) {
+        int n = strlen(in + j);
+        FormFeed(&form, in + j, (n < piece) ? n : piece);
+      }
+      FormEnd(&form);
+      Check("FormFeed", in, formOut, pairs[i][1]);
+    }
+  }
+  {
+    // A field too big for the buffer is dropped, the rest still come through
+    char field[16];
+    FormParser form;
+    formOut[0] = 0;
+    FormBegin(&form, field, sizeof(field), FormCollect);
+    const char *in = "a=1&long=0123456789abcdef&b=2";
+    FormFeed(&form, in, strlen(in));
+    FormEnd(&form);
+    Check("FormFeed", in, formOut, "a:1|b:2|");
+    if (form.dropped != 1) { printf("FAIL dropped=%d\n", form.dropped); failures++; }
+  }
+
+  // Random well-formed strings must decode the same as the old code did
+  srand(1);
+  static const char *tokens[] = { "a", "Z", "9", "+", "%20", "%7e", "%7E", "%00", "%ff", "/", "." };
+  for (int i=0; i<100000; i++) {
+    char in[128], a[128], b[128];
+    in[0] = 0;
+    int n = rand() % 20;
+    for (int j=0; j<n; j++) strcat(in, tokens[rand() % (sizeof(tokens)/sizeof(tokens[0]))]);
+    strcpy(a, in);
+    strcpy(b, in);
+    OldURLDecode(a);
+    URLDecode(b);
+    if (strcmp(a, b)) {
+      Check("Random", in, b, a);
+      break;
+    }
+  }
+
+  // Pathological inputs
+  Bench("all escapes", "%41", 20000);
+  Bench("all plus", "+", 60000);
+  Bench("escaped pairs", "n%3D=v%26&", 6000);
+  Bench("many empty pairs", "&", 60000);
+  Bench("bad escapes", "%%z", 20000);
+  Bench("setup form", "ssid=My%20Network&pass=p%40ss%21w0rd&mhost=broker.example.com&", 600);
+
+  {
+    // Streaming a large body through a small field buffer
+    const char *pattern = "ssid=My%20Network&pass=p%40ss%21w0rd&mhost=broker.example.com&";
+    int reps = 20000;
+    char field[128];
+    FormParser form;
+    double t0 = Now();
+    FormBegin(&form, field, sizeof(field), FormCount);
+    for (int i=0; i<reps; i++) FormFeed(&form, pattern, strlen(pattern));
+    FormEnd(&form);
+    double t1 = Now();
+    printf("%-24s %7d bytes: streamed %7.3f ms (%d pairs) in a %d byte buffer\n", "streamed form", (int)strlen(pattern) * reps, (t1-t0)*1e3, form.fields, (int)sizeof(field));
+  }
+
+  printf("%s\n", failures ? "FAILED" : "PASSED");
+  return failures ? 1 : 0;
+}
+#endif
@@ -0,0 +1,61 @@
+/*
+  PsychoPlug
+  ESP8266 based remote outlet with standalone timer and MQTT integration
+  
+  Copyright (C) 2017  Earle F. Philhower, III
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _form_h
+#define _form_h
+
+#ifndef TEST_WEB
+#include <Arduino.h>
+#endif
+
+// Web decoding utilities, all in-place
+void Base64Decode(char *str); // In-place B64 decode
+void URLDecode(char *ptr); // In-place URL decode
+bool ParseParam(char **paramStr, char **name, char **value); // Split off and URL decode the next name=value pair
+
+// Streaming form parser.  Body bytes are fed in as they arrive and each
+// name=value pair is URL decoded and handed to the handler once its '&' (or
+// the end) is seen, so bodies of any length need only one field's worth of RAM.
+// The handler is also called once with NULLs just before the first field.
+typedef void (*FormHandler)(char *name, char *value);
+
+typedef struct {
+  char *buff; // Holds the current, still encoded, field
+  int size;
+  int len;
+  int fields; // Fields handed out so far
+  bool overflow; // Current field didn't fit and will be dropped
+  int dropped; // Fields dropped for being too long
+  FormHandler handler;
+} FormParser;
+
+void FormBegin(FormParser *form, char *buff, int size, FormHandler handler);
+void FormFeed(FormParser *form, const char *data, int len);
+void FormEnd(FormParser *form); // Body done, hand out the last field
+
+// HTML FORM parsing
+int ParseInt(char *src, int *dest);
+void Read4Int(char *str, byte *p);
+#define ParamText(name, dest)     { if (!strcmp(namePtr, (name))) strlcpy((dest), valPtr, sizeof(dest)); }
+#define ParamCheckbox(name, dest) { if (!strcmp(namePtr, (name))) (dest) = !strcmp("on", valPtr); }
+#define ParamInt(name, dest)      { if (!strcmp(namePtr, (name))) ParseInt(valPtr, &dest); }
+#define Param4Int(name, dest)     { if (!strcmp(namePtr, (name))) Read4Int(valPtr, (dest)); }
+
+#endif
@@ -1,13 +1,23 @@
 #!/bin/bash
 
+# KEYTYPE=rsa (default) or KEYTYPE=ec for an ECDSA P-256 key and certificate.
+# EC keys are much cheaper for the plug to use during the TLS handshake.
+KEYTYPE=${KEYTYPE:-rsa}
 # 1024 or 512.   512 saves memory...
 BITS=512
 C=$PWD
 pushd /tmp
 
-openssl genrsa -out tls.ca_key.pem $BITS
-openssl genrsa -out tls.key_$BITS.pem $BITS
-openssl rsa -in tls.key_$BITS.pem -out tls.key_$BITS -outform DER
+if [ "$KEYTYPE" == "ec" ]; then
+  BITS=256
+  openssl ecparam -name prime256v1 -genkey -noout -out tls.ca_key.pem
+  openssl ecparam -name prime256v1 -genkey -noout -out tls.key_$BITS.pem
+  openssl ec -in tls.key_$BITS.pem -out tls.key_$BITS -outform DER
+else
+  openssl genrsa -out tls.ca_key.pem $BITS
+  openssl genrsa -out tls.key_$BITS.pem $BITS
+  openssl rsa -in tls.key_$BITS.pem -out tls.key_$BITS -outform DER
+fi
 cat > certs.conf <<EOF
 [ req ]
 distinguished_name = req_distinguished_name
@@ -24,6 +34,12 @@ openssl x509 -req -in tls.x509_$BITS.req  -out tls.x509_$BITS.pem -sha256 -CAcre
 openssl x509 -in tls.ca_x509.pem -outform DER -out tls.ca_x509.cer
 openssl x509 -in tls.x509_$BITS.pem -outform DER -out tls.x509_$BITS.cer
 
+# certtype.h tells the sketch which kind of key it holds
+if [ "$KEYTYPE" == "ec" ]; then
+  echo "#define TLS_EC_CERT" > "$C/certtype.h"
+else
+  echo -n > "$C/certtype.h"
+fi
 xxd -i tls.key_$BITS       | sed 's/.*{//' | sed 's/\};//' | sed 's/unsigned.*//' > "$C/key.h"
 xxd -i tls.x509_$BITS.cer  | sed 's/.*{//' | sed 's/\};//' | sed 's/unsigned.*//' > "$C/x509.h"
 
@@ -0,0 +1,56 @@
+#!/usr/bin/perl
+
+# Turn everything in static/ into flash resident arrays, plain and gzipped.
+# Usage: ./make-static-h.pl > static.h
+
+use IO::Compress::Gzip qw(gzip $GzipError);
+use Digest::MD5 qw(md5_hex);
+
+%types = ( "js" => "application/javascript", "css" => "text/css", "html" => "text/html" );
+
+sub carray {
+	my ($name, $data) = @_;
+	my $out = "static const uint8_t $name\[\] PROGMEM = {";
+	for ($i = 0; $i < length($data); $i++) {
+		$out .= "\n  " if (($i % 16) == 0);
+		$out .= sprintf("0x%02x,", ord(substr($data, $i, 1)));
+	}
+	$out .= "\n};\n";
+	return $out;
+}
+
+print "// Generated by make-static-h.pl from static/, do not edit\n\n";
+
+opendir D, "static" or die "No static/ directory";
+@files = sort grep { -f "static/$_" } readdir D;
+closedir D;
+
+foreach $f (@files) {
+	open F, "<static/$f";
+	binmode F;
+	local $/;
+	$data = <F>;
+	close F;
+	# Minimal header, no name or timestamp, so the output only changes with the input
+	gzip(\$data => \$gz, -Level => 9, Minimal => 1) or die "gzip failed: $GzipError";
+
+	($ext) = ($f =~ /\.([^.]+)$/);
+	$type = $types{$ext};
+	die "Unknown type for $f" if ($type eq "");
+	$var = "static_" . $f;
+	$var =~ s/[^A-Za-z0-9]/_/g;
+
+	print carray($var, $data);
+	print carray($var . "_gz", $gz);
+	print "static const char $var" . "_type[] PROGMEM = \"$type\";\n";
+	print "static constexpr char $var" . "_path[] PROGMEM = \"$f\";\n\n";
+	$tag = "0x" . substr(md5_hex($data), 0, 8);
+	push @table, "  { WebHash($var" . "_path), $var" . "_path, $var" . "_type, $var, sizeof($var), $var" . "_gz, sizeof($var" . "_gz), $tag },\n";
+	printf STDERR "%s: %d bytes, %d gzipped\n", $f, length($data), length($gz);
+}
+
+print "static const WebStatic webStatic[] PROGMEM = {\n";
+foreach $t (@table) {
+	print $t;
+}
+print "};\n";
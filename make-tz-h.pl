@@ -158,12 +158,17 @@ foreach $f (@files) {
 			$h = int($h);
 			$m = int($m);
 			push @zone, "{REPLACEME, /*$zonename*/ \"$zonename\", $h, $m, $rules, \"$fmt\"},\n";
+			push @names, $zonename;
 			$zonename= "";
 		}
 	}
 	close F
 }
 @zone = sort @zone;
+for ($i = 0; $i < @zone; $i++) {
+	($n) = ($zone[$i] =~ /\/\*(.*?)\*\//);
+	$tzindex{$n} = $i;
+}
 
 foreach $f (@files) {
         open F, "<$f";
@@ -180,6 +185,8 @@ foreach $f (@files) {
 				$thisname = $1;
 				if ($thisname eq $destzone) {
 					push @link, "{ REPLACEME, \"$linkname\", $i /*$thisname*/ },\n";
+					push @names, $linkname;
+					$tzindex{$linkname} = $i if (!exists($tzindex{$linkname}));
 					break;
 				}
 			}
@@ -257,4 +264,32 @@ foreach $z (@link)
 }
 
 
-print "};\n"
+print "};\n";
+
+# Every zone and link name, sorted and pre-rendered as <option>s so the web UI can send them as-is
+%seen = ();
+@names = sort grep { !$seen{$_}++ } @names;
+print "\n// Sorted <option> list of all names, for the web UI\n";
+print "static const char tzOptions[] ICACHE_RODATA_ATTR =\n";
+$off = 0;
+foreach $n (@names) {
+	$opt = "<option>$n</option>";
+	print "\"$opt\"\n";
+	push @offset, $off;
+	$off += length($opt);
+}
+print ";\n";
+print "// Where each name's <option> starts in tzOptions\n";
+print "static const uint16_t tzOptionOffset[] ICACHE_RODATA_ATTR = {";
+for ($i = 0; $i < @offset; $i++) {
+	print "\n" if (($i % 16) == 0);
+	print "$offset[$i],";
+}
+print "\n};\n";
+print "// mtimezone[] entry for each name, so lookups are a binary search of tzOptionOffset\n";
+print "static const uint16_t tzOptionZone[] ICACHE_RODATA_ATTR = {";
+for ($i = 0; $i < @names; $i++) {
+	print "\n" if (($i % 16) == 0);
+	print "$tzindex{$names[$i]},";
+}
+print "\n};\n";
@@ -27,10 +27,15 @@
 #include "mqtt.h"
 #include "settings.h"
 #include "relay.h"
+#include "schedule.h"
+#include "events.h"
 
 // MQTT interface
 static WiFiClient *wifiMQTT = NULL;
 static MQTTClient mqttClient;
+static unsigned long mqttReconnects = 0;
+static unsigned long mqttPauses = 0;
+static unsigned long mqttResumeMS = 0; // Don't reconnect before this, 0 if not paused
 
 // Callback for the MQTT library
 void messageReceived(String& topic, String& payload)
@@ -50,6 +55,14 @@ void messageReceived(String& topic, String& payload)
       SetRelay(false);
     else if (!strcasecmp_P(p, PSTR("toggle")) )
       SetRelay(!GetRelay());
+    else if (!strcasecmp_P(p, PSTR("pulseon")) )
+      PerformAction(ACTION_PULSEON);
+    else if (!strcasecmp_P(p, PSTR("pulseoff")) )
+      PerformAction(ACTION_PULSEOFF);
+    else if (!strncasecmp_P(p, PSTR("onfor"), 5) ) { // "onfor" or "onfor <minutes>"
+      long mins = atol(p+5);
+      if (mins >= 0 && mins <= 24 * 60) PerformAction(ACTION_ONFOR, mins * 60000UL);
+    }
   }
 }
 
@@ -80,10 +93,14 @@ void ManageMQTT()
 
   // Only have MQTT loop if we're connected and configured
   if (mqttClient.connected()) {
-    mqttClient.loop();
-    delay(10);
+    mqttClient.loop(); // loop() idles instead of a delay here, when there's nothing else to do
   } else {
+    // Paused, or not enough memory for the connection (web clients come first)
+    if (mqttResumeMS && (long)(millis() - mqttResumeMS) < 0) return;
+    if (ESP.getFreeHeap() < (settings.mqttSSL ? MQTT_MIN_HEAP_SSL : MQTT_MIN_HEAP)) return;
+    mqttResumeMS = 0;
     LogPrintf("MQTT disconnected, reconnecting\n");
+    mqttReconnects++;
     mqttClient.connect(settings.mqttClientID, settings.mqttUser, settings.mqttPass);
     if (mqttClient.connected() ) {
       char topic[64];
@@ -103,8 +120,29 @@ void StopMQTT()
   }
 }
 
+void PauseMQTT()
+{
+  if (!settings.mqttEnable || !mqttClient.connected()) return;
+  LogPrintf("MQTT paused, free heap = %d\n", ESP.getFreeHeap());
+  StopMQTT();
+  mqttPauses++;
+  mqttResumeMS = millis() + MQTT_PAUSE_MS;
+}
+
+bool MQTTConnected()
+{
+  return settings.mqttEnable && mqttClient.connected();
+}
+
+void MQTTStats(unsigned long *reconnects, unsigned long *pauses)
+{
+  *reconnects = mqttReconnects;
+  *pauses = mqttPauses;
+}
+
 void MQTTPublish(const char *key, const char *value)
 {
+  EventsPublish(key, value);
   if (isSetup && settings.mqttEnable && mqttClient.connected()) {
     char topic[64];
     snprintf_P(topic, sizeof(topic), PSTR("%s/%s"), settings.mqttTopic, key);
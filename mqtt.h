@@ -21,9 +21,18 @@
 #ifndef _mqtt_h
 #define _mqtt_h
 
+// Free heap needed before we'll (re)connect, TLS needs a lot more than plain TCP
+#define MQTT_MIN_HEAP (8000)
+#define MQTT_MIN_HEAP_SSL (24000)
+// How long a pause for memory lasts before we try to reconnect
+#define MQTT_PAUSE_MS (10000)
+
 void StartMQTT();
 void ManageMQTT();
 void StopMQTT();
+void PauseMQTT(); // Disconnect to free heap for a while, ManageMQTT() reconnects later
+bool MQTTConnected();
+void MQTTStats(unsigned long *reconnects, unsigned long *pauses);
 
 void MQTTPublish(const char *key, const char *value);
 void MQTTPublishInt(const char *key, const int value);
@@ -36,6 +36,10 @@
 #include "timezone.h"
 #include "dns.h"
 #include "web.h"
+#include "api.h"
+#include "events.h"
+#include "timer.h"
+#include "setupform.h"
 
 bool isSetup = false;
 
@@ -51,10 +55,12 @@ static WiFiServer redirector(80);
 // OTA updates on the cheap...
 static ESP8266WebServer *otaServer = NULL;
 static ESP8266HTTPUpdateServer *otaUpdateServer = NULL;
+static unsigned long killUpdateTime = 0;
 
 
-// HTTPS interface
-static const uint8_t rsakey[] ICACHE_RODATA_ATTR = {
+// HTTPS interface.  certtype.h defines TLS_EC_CERT when make-certs-256.sh was run with KEYTYPE=ec
+#include "certtype.h"
+static const uint8_t tlskey[] ICACHE_RODATA_ATTR = {
 #include "key.h"
 };
 
@@ -66,6 +72,34 @@ static const uint8_t x509[] ICACHE_RODATA_ATTR = {
 // specify the port to listen on as an argument
 static WiFiServerSecure https(443);
 
+// TLS session resumption cache.  Returning clients that present a cached
+// session ID skip the RSA private key operation entirely.
+#define TLS_SESSION_SLOTS (4)
+static BearSSL::ServerSession tlsSessionStore[TLS_SESSION_SLOTS];
+static BearSSL::ServerSessions tlsSessions(tlsSessionStore, TLS_SESSION_SLOTS);
+// BearSSL doesn't say if a handshake resumed a session, but a full one always saves a
+// new session to the cache.  Its LRU entries start with the (masked) 32 byte session ID,
+// so if no ID in the store changed over a handshake then it was a resumption.
+#define TLS_SESSION_IDLEN (32)
+
+// Client connection slots, shared by the HTTP redirector and HTTPS servers
+#define WEB_MAX_CONNS (4)
+static WebConn conns[WEB_MAX_CONNS];
+// Free heap needed before we'll accept (and handshake) another HTTPS client
+#define WEB_ACCEPT_MIN_HEAP (20000)
+
+// Connections accepted (i.e. TLS handshakes) vs. requests served on them
+static unsigned long webHandshakes = 0;
+static unsigned long webRequests = 0;
+static unsigned long tlsResumed = 0;
+static unsigned long tlsHandshakeMS = 0; // Total time spent in handshakes
+// HTTPS connections accepted while MQTT stayed connected, each one used to force a reconnect
+static unsigned long mqttKept = 0;
+
+// Longest a loop() pass will idle for, short enough that the button, LED and new connections don't notice
+#define LOOP_IDLE_MS (20)
+static unsigned long idleMS = 0; // Total time idled
+
 // Return a *static* char * to an IP formatted string, so DO NOT USE MORE THAN ONCE PER LINE
 const char *FormatIP(const byte ip[4], char *buff, int buffLen)
 {
@@ -80,7 +114,60 @@ const char *FormatBool(bool b)
 
 
 
-void PrintSettings(WiFiClient *client)
+#ifdef TLS_EC_CERT
+// ECDSA P-256 server certificate, signed by an EC CA.  BearSSL parses these in
+// RAM and keeps the parsed copies, so stage the flash arrays through the heap.
+void SetECCert()
+{
+  uint8_t *buff = (uint8_t *)malloc(sizeof(x509));
+  if (!buff) {
+    LogPrintf("Unable to allocate %d bytes for certificate\n", (int)sizeof(x509));
+    return;
+  }
+  memcpy_P(buff, x509, sizeof(x509));
+  BearSSL::X509List *chain = new BearSSL::X509List(buff, sizeof(x509));
+  free(buff);
+  buff = (uint8_t *)malloc(sizeof(tlskey));
+  if (!buff) {
+    LogPrintf("Unable to allocate %d bytes for private key\n", (int)sizeof(tlskey));
+    delete chain;
+    return;
+  }
+  memcpy_P(buff, tlskey, sizeof(tlskey));
+  BearSSL::PrivateKey *key = new BearSSL::PrivateKey(buff, sizeof(tlskey));
+  memset(buff, 0, sizeof(tlskey));
+  free(buff);
+  https.setECCert(chain, BR_KEYTYPE_EC, key);
+}
+#endif
+
+// FNV-1a of every session ID in the TLS cache, changes whenever a session is added
+static uint32_t TLSSessionIDHash()
+{
+  uint32_t hash = 2166136261UL;
+  for (int i=0; i<TLS_SESSION_SLOTS; i++) {
+    for (int j=0; j<TLS_SESSION_IDLEN; j++) hash = (hash ^ tlsSessionStore[i][j]) * 16777619UL;
+  }
+  return hash;
+}
+
+// Accept a pending HTTPS connection (which runs the TLS handshake) and keep handshake statistics
+WiFiClientSecure AcceptHTTPS()
+{
+  unsigned long startMS = millis();
+  uint32_t idHash = TLSSessionIDHash();
+  WiFiClientSecure client = https.available();
+  if (client) {
+    unsigned long ms = millis() - startMS;
+    webHandshakes++;
+    tlsHandshakeMS += ms;
+    if (TLSSessionIDHash() == idHash) tlsResumed++;
+  }
+  return client;
+}
+
+
+void PrintSettings(WebWriter *client)
 {
   char buff[16];
  
@@ -106,6 +193,8 @@ void PrintSettings(WiFiClient *client)
   WebPrintf(client, "<br><h1>Power Settings</h1>\n");
 //  WebPrintf(client, "System Voltage: %d<br>\n", settings.voltage);
   WebPrintf(client, "On after power failure: %s<br>\n", FormatBool(settings.onAfterPFail));
+  WebPrintf(client, "Pulse length: %d ms<br>\n", settings.pulseMS);
+  WebPrintf(client, "On For Time length: %d minutes<br>\n", settings.onForMins);
 
   WebPrintf(client, "<br><H1>MQTT</h1>\n");
   WebPrintf(client, "Enabled: %s<br>\n", FormatBool(settings.mqttEnable));
@@ -145,6 +234,7 @@ void StartSetupAP()
   WiFi.softAP(ssid);
 
   StartDNS(&setupIP);
+  WiFi.scanNetworks(true); // Have the network list ready for the setup page
   
   LogPrintf("Waiting for connection\n");
   https.begin();
@@ -160,6 +250,10 @@ void StartSTA()
   
   if (settings.hostname[0])
     WiFi.hostname(settings.hostname);
+
+  // The radio can power down between the AP's beacons whenever loop() idles.  Light sleep would stop
+  // the CPU's clock too, but then incoming connections wait for the next wakeup
+  WiFi.setSleepMode(WIFI_MODEM_SLEEP);
   
   if (!settings.useDHCP) {
     WiFi.config(settings.ip, settings.gateway, settings.netmask, settings.dns);
@@ -203,12 +297,11 @@ void StartSTA()
 }
 
 
-// Setup web page
-void SendSetupHTML(WiFiClient *client)
+// Setup form, cnt is the WiFi scan result
+void SendSetupForm(WebWriter *client, int cnt)
 {
   char buff[16];
 
-  LogPrintf("+SendSetupHTML\n");
   WebHeaders(client, NULL);
   WebPrintf(client, DOCTYPE);
   WebPrintf(client, "<html><head><title>PsychoPlug Setup</title>" ENCODING "</head>\n");
@@ -217,8 +310,9 @@ void SendSetupHTML(WiFiClient *client)
 
   WebPrintf(client, "<br><h1>WiFi Network</h1>\n");
   WebFormText(client, PSTR("SSID"), "ssid", settings.ssid, true);
-  int cnt = WiFi.scanNetworks();
-  if (cnt==0) {
+  if (cnt == WIFI_SCAN_RUNNING) {
+    WebPrintf(client, "Discovered networks: Scanning, reload the page to see them.<br>\n");
+  } else if (cnt==0) {
     WebPrintf(client, "Discovered networks: No WIFI networks detected.<br>\n");
   } else {
     WebPrintf(client, "Discovered networks: <select onchange=\"setval(this)\">");
@@ -248,6 +342,8 @@ void SendSetupHTML(WiFiClient *client)
   WebPrintf(client, "<br><h1>Power</h1>\n");
   //WebFormText(client, PSTR("Mains Voltage"), "voltage", settings.voltage, true);
   WebFormCheckbox(client, PSTR("Start powered up after power loss"), "pf", settings.onAfterPFail, true);
+  WebFormText(client, PSTR("Pulse length (ms)"), "pulse", settings.pulseMS, true);
+  WebFormText(client, PSTR("On For Time length (minutes)"), "onfor", settings.onForMins, true);
 
   WebPrintf(client, "<br><H1>MQTT</h1>\n");
   const char *ary2[] = { "mhost", "mport", "mssl", "muser", "mpass", "mtopic", "mclientid", "" };
@@ -266,12 +362,40 @@ void SendSetupHTML(WiFiClient *client)
 
   WebPrintf(client, "<input type=\"submit\" value=\"Submit\">\n");
   WebPrintf(client, "</form></body></html>\n");
+}
+
+
+// Setup web page
+void SendSetupHTML(WebWriter *client)
+{
+  LogPrintf("+SendSetupHTML\n");
+  // Scan in the background so other connections aren't held up, results are kept between pages
+  int cnt = WiFi.scanComplete();
+  if (cnt == WIFI_SCAN_FAILED) {
+    WiFi.scanNetworks(true);
+    cnt = WIFI_SCAN_RUNNING;
+  }
+
+  // The page only changes with the settings or the networks found
+  uint32_t version = SettingsGeneration() ^ ((uint32_t)cnt << 24);
+  for (int i=0; i<cnt; i++) {
+    String ssid = WiFi.SSID(i);
+    for (const char *p = ssid.c_str(); *p; p++) version = (version ^ (uint8_t)*p) * 16777619UL;
+  }
+  bool cached = WebNotModified(client, version);
+  if (!cached) SendSetupForm(client, cnt);
+
+  if (cnt != WIFI_SCAN_RUNNING) {
+    // Refresh the list for next time
+    WiFi.scanDelete();
+    WiFi.scanNetworks(true);
+  }
   LogPrintf("-SendSetupHTML\n");
 }
 
 
 // Status Web Page
-void SendStatusHTML(WiFiClient *client)
+void SendStatusHTML(WebWriter *client)
 {
   bool curPower = GetRelay();
   char tmp[64];
@@ -293,52 +417,64 @@ void SendStatusHTML(WiFiClient *client)
   ms -= mins * (60L * 1000L);
   unsigned long secs = ms / (1000L);
   WebPrintf(client, "Uptime: %d days, %d hours, %d minutes, %d seconds<br>\n", days, hours, mins, secs);
-  WebPrintf(client, "Power: %s <a href=\"%s\">Toggle</a><br><br>\n",curPower?"ON":"OFF", curPower?"off.html":"on.html");
-//  WebPrintf(client, "Current: %dmA (%dW @ %dV)<br>\n", GetCurrentMA(), (GetCurrentMA()* settings.voltage) / 1000, settings.voltage);
-
-  WebPrintf(client, "<table border=\"1px\">\n");
-  WebPrintf(client, "<tr><th>#</th><th>Sun</th><th>Mon</th><th>Tue</th><th>Wed</th><th>Thu</th><th>Fri</th><th>Sat</th><th>Time</th><th>Action</th><th>EDIT</th></tr>\n");
-  char *buff = (char *)alloca(500); // By construction this will fit a row of the table
-  for (byte i=0; i<MAXEVENTS; i++) {
-    int len = 0;
-    sprintf_P(buff+len, PSTR("<tr><td>%d.</td>"), i+1);
-    len += strlen(buff+len);
-    for (byte j=0; j<7; j++) {
-      sprintf_P(buff+len, PSTR("<td>%s</td>"), (settings.event[i].dayMask & (1<<j))?"[X]":"[&nbsp;]");
-      len += strlen(buff+len);
+  WebPrintf(client, "Idle: %lu%%<br>\n", (unsigned long)((idleMS * 100ULL) / (millis() ? millis() : 1)));
+  WebPrintf(client, "HTTPS: %lu requests over %lu connections<br>\n", webRequests, webHandshakes);
+  WebPrintf(client, "Request latency: 50%% &lt;%lums, 90%% &lt;%lums, 99%% &lt;%lums<br>\n", WebLatencyPercentile(50), WebLatencyPercentile(90), WebLatencyPercentile(99));
+  for (int i=0; i<WEB_MAX_CONNS; i++) {
+    if (conns[i].served) {
+      WebPrintf(client, "Connection slot %d: %lu requests, %lums average, %lums max<br>\n", i, conns[i].served, conns[i].totalMS / conns[i].served, conns[i].maxMS);
     }
-    if (settings.use12hr) {
-      int prthr = settings.event[i].hour%12;
-      if (!prthr) prthr = 12;
-      sprintf_P(buff+len, PSTR("<td>%d:%02d %s</td>"), prthr, settings.event[i].minute, (settings.event[i].hour<12)?"AM":"PM");
-      len += strlen(buff+len);
-    } else {
-      sprintf_P(buff+len, PSTR("<td>%d:%02d</td>"), settings.event[i].hour, settings.event[i].minute);
-      len += strlen(buff+len);
-    }
-    char str[16];
-    sprintf_P(buff+len, PSTR("<td>%s</td>"), GetActionString(settings.event[i].action, str, sizeof(str)));
-    len += strlen(buff+len);
-    sprintf_P(buff+len, PSTR("<td><a href=\"edit.html?id=%d\">Edit</a></td></tr>\r\n"), i);
-    client->print(buff);
   }
-  WebPrintf(client, "</table><br>\n");
+  if (settings.mqttEnable) {
+    unsigned long reconnects, pauses;
+    MQTTStats(&reconnects, &pauses);
+    WebPrintf(client, "MQTT: %s, %lu reconnects, %lu paused for memory, %lu reconnects avoided<br>\n", MQTTConnected()?"connected":"disconnected", reconnects, pauses, mqttKept);
+  }
+  unsigned long basicCount, basicUS, sessCount, sessUS;
+  WebAuthStats(&basicCount, &basicUS, &sessCount, &sessUS);
+  if (basicCount || sessCount) {
+    WebPrintf(client, "Auth: %lu password checks, %lu us average, %lu session checks, %lu us average<br>\n",
+              basicCount, basicCount ? basicUS / basicCount : 0, sessCount, sessCount ? sessUS / sessCount : 0);
+    unsigned long created, reused;
+    WebSessionStats(&created, &reused);
+    WebPrintf(client, "Sessions: %lu created, %lu reused<br>\n", created, reused);
+  }
+  if (webHandshakes) {
+    WebPrintf(client, "TLS: %lu ms average handshake, %lu%% sessions resumed<br>\n", tlsHandshakeMS / webHandshakes, (tlsResumed * 100) / webHandshakes);
+  }
+  WebPrintf(client, "Power: %s <a href=\"%s\">Toggle</a>",curPower?"ON":"OFF", curPower?"off.html":"on.html");
+  long left = RelayTimeLeft();
+  if (left >= 0) WebPrintf(client, " (%s in %lu seconds)", curPower?"off":"on", (left + 999) / 1000);
+  WebPrintf(client, "<br><br>\n");
+//  WebPrintf(client, "Current: %dmA (%dW @ %dV)<br>\n", GetCurrentMA(), (GetCurrentMA()* settings.voltage) / 1000, settings.voltage);
+
+  // Rows are filled in by sched.js from the JSON API
+  WebPrintf(client, "<table border=\"1px\" id=\"sched\" data-max=\"%d\" data-12hr=\"%d\"></table><br>\n", MAXEVENTS, settings.use12hr?1:0);
+  WebPrintf(client, "<script type=\"text/javascript\" src=\"sched.js?v=%08lx\"></script>\n", (unsigned long)WebStaticTag("sched.js"));
   WebPrintf(client, "<a href=\"reconfig.html\">Change System Configuration</a><br><br>\n");
 
   WebPrintf(client, "CGI Action URLs: <a href=\"on.html\">On</a> <a href=\"off.html\">Off</a> <a href=\"toggle.html\">Toggle</a> <a href=\"pulseoff.html\">Pulse Off</a> ");
-  WebPrintf(client, "<a href=\"pulseon.html\">Pulse On</a> <a href=\"status.html\">Status</a> <a href=\"hang.html\">Reset</a><br>\n");
+  WebPrintf(client, "<a href=\"pulseon.html\">Pulse On</a> <a href=\"onfor.html\">On For %d Minutes</a> <a href=\"status.html\">Status</a> <a href=\"hang.html\">Reset</a><br>\n", settings.onForMins);
   WebPrintf(client, "<br>\n<a href=\"enableupdate.html\">Enable HTTP update of firmware for 10 minutes</a>\n");
   WebPrintf(client, "</body>\n");
 }
 
-// Edit Rule
-void SendEditHTML(WiFiClient *client, int id)
+// Edit Rule, id==EventCount() adds a new one
+void SendEditHTML(WebWriter *client, int id)
 {
+  if (WebNotModified(client, SettingsGeneration())) return;
+  static const Event blank = { 0, 0, 0, ACTION_NONE };
+  const Event *e = GetEvent(id);
+  if (!e) e = &blank;
   WebHeaders(client, NULL);
   WebPrintf(client, DOCTYPE);
   WebPrintf(client, "<html><head><title>PsychoPlug Rule Edit</title>" ENCODING "</head>\n");
   WebPrintf(client, "<body>\n");
-  WebPrintf(client, "<h1>Editing rule %d</h1>\n", id+1);
+  if (id < EventCount()) {
+    WebPrintf(client, "<h1>Editing rule %d</h1>\nSet the action to None to delete it.<br>\n", id+1);
+  } else {
+    WebPrintf(client, "<h1>New rule %d</h1>\n", id+1);
+  }
 
   WebPrintf(client, "<form action=\"update.html\" method=\"POST\">\n");
   WebPrintf(client, "<input type=\"hidden\" name=\"id\" value=\"%d\">\n", id);
@@ -351,41 +487,41 @@ void SendEditHTML(WiFiClient *client, int id)
   }
   WebPrintf(client, "\">All</button></td>\n");
   for (byte j=0; j<7; j++) {
-    WebPrintf(client, "<td><input type=\"checkbox\" id=\"%c\" name=\"%c\" %s></td>\n", 'a'+j, 'a'+j, settings.event[id].dayMask & (1<<j)?"checked":"");
+    WebPrintf(client, "<td><input type=\"checkbox\" id=\"%c\" name=\"%c\" %s></td>\n", 'a'+j, 'a'+j, e->dayMask & (1<<j)?"checked":"");
   }
     WebPrintf(client, "<td><select name=\"hr\">");
   if (settings.use12hr) {
-    int selhr = settings.event[id].hour%12;
+    int selhr = e->hour%12;
     if (!selhr) selhr = 12;
     for (int j=1; j<=12; j++) {
       WebPrintf(client, "<option %s>%d</option>", selhr==j?"selected":"", j)
     }
   } else {
     for (int j=0; j<24; j++) {
-      WebPrintf(client, "<option %s>%d</option>", settings.event[id].hour==j?"selected":"", j)
+      WebPrintf(client, "<option %s>%d</option>", e->hour==j?"selected":"", j)
     }
   }
   WebPrintf(client, "</select>:<select name=\"mn\">");
   char *buff = (char *)alloca(20*60+10);
   int len=0;
   for (int j=0; j<60; j++) {
-    sprintf_P(buff+len, PSTR("<option %s>%02d</option>"), (settings.event[id].minute==j)?"selected":"", j);
+    sprintf_P(buff+len, PSTR("<option %s>%02d</option>"), (e->minute==j)?"selected":"", j);
     len += strlen(buff+len);
   }
   client->print(buff);
   WebPrintf(client, "</select> ");
   if (settings.use12hr)
-    WebPrintf(client, "<select name=\"ampm\"><option %s>AM</option><option %s>PM</option></select></td>", settings.event[id].hour<12?"selected":"", settings.event[id].hour>=12?"selected":"");
+    WebPrintf(client, "<select name=\"ampm\"><option %s>AM</option><option %s>PM</option></select></td>", e->hour<12?"selected":"", e->hour>=12?"selected":"");
   WebPrintf(client, "<td>\n<select name=\"action\">");
   char str[16];
-  for (int j=0; j<=ACTION_MAX; j++) WebPrintf(client, "<option %s>%s</option>", settings.event[id].action==j?"selected":"", GetActionString(j, str, sizeof(str)));
+  for (int j=0; j<=ACTION_MAX; j++) WebPrintf(client, "<option %s>%s</option>", e->action==j?"selected":"", GetActionString(j, str, sizeof(str)));
   WebPrintf(client, "</select></td></table><br>\n");
   WebPrintf(client, "<input type=\"submit\" value=\"Submit\">\n");
   WebPrintf(client, "</form></body></html>\n");
 }
 
 // Success page, auto-refresh in 1 sec to index
-void SendSuccessHTML(WiFiClient *client)
+void SendSuccessHTML(WebWriter *client)
 {
   WebHeaders(client, PSTR("Refresh: 1; url=index.html\r\n"));
   WebPrintf(client, DOCTYPE);
@@ -413,7 +549,14 @@ void setup()
   StartRelay(settings.onAfterPFail?true:false);
 
   // Load our certificate and key from FLASH before we start
-  https.setServerKeyAndCert_P(rsakey, sizeof(rsakey), x509, sizeof(x509));
+#ifdef TLS_EC_CERT
+  SetECCert();
+#else
+  https.setServerKeyAndCert_P(tlskey, sizeof(tlskey), x509, sizeof(x509));
+#endif
+  https.setCache(&tlsSessions);
+
+  StartWeb();
 
   // Make sure ESP isn't doing any wifi operations.  Sometimes starts back up in AP mode, for example
   WiFi.disconnect();
@@ -431,62 +574,7 @@ void setup()
 }
 
 
-void ParseSetupForm(char *params)
-{
-  char *valPtr;
-  char *namePtr;
-  
-  // Checkboxes don't actually return values if they're unchecked, so by default these get false
-  settings.useDHCP = false;
-  settings.onAfterPFail = false;
-  settings.mqttEnable = false;
-  settings.mqttSSL = false;
-  settings.use12hr = false;
-  settings.usedmy = false;
-  
-  while (ParseParam(&params, &namePtr, &valPtr)) {
-    ParamText("ssid", settings.ssid);
-    ParamText("pass", settings.psk);
-    ParamText("hn", settings.hostname);
-    ParamCheckbox("dh", settings.useDHCP);
-    Param4Int("ip", settings.ip);
-    Param4Int("nm", settings.netmask);
-    Param4Int("gw", settings.gateway);
-    Param4Int("dns", settings.dns);
-    Param4Int("logsvr", settings.logsvr);
-    
-    ParamText("ntp", settings.ntp);
-    ParamText("tz", settings.timezone);
-    ParamCheckbox("use12hr", settings.use12hr);
-    ParamCheckbox("usedmy", settings.usedmy);
-
-    ParamCheckbox("pf", settings.onAfterPFail);
-
-    ParamCheckbox("mEn", settings.mqttEnable);
-    ParamText("mhost", settings.mqttHost);
-    ParamInt("mport", settings.mqttPort);
-//    int v;
-//    ParamInt("voltage", v);
-//    if ((v<80) || (v>255)) v=120; // Sanity-check
-//    settings.voltage = v;
-    ParamCheckbox("mssl", settings.mqttSSL);
-    ParamText("mtopic", settings.mqttTopic);
-    ParamText("mclientid", settings.mqttClientID);
-    ParamText("muser", settings.mqttUser);
-    ParamText("mpass", settings.mqttPass);
-
-    ParamText("uiuser", settings.uiUser);
-    char tempPass[64];
-    ParamText("uipass", tempPass);
-    if (strcmp_P(tempPass, PSTR("*****"))) {
-      // Was changed, regenerate salt and store it
-      HashPassword(tempPass, settings.uiSalt, settings.uiPassEnc);
-    }
-    memset(tempPass, 0, sizeof(tempPass)); // I think I'm paranoid
-  }
-}
-
-void SendRebootHTML(WiFiClient *client)
+void SendRebootHTML(WebWriter *client)
 {
   WebHeaders(client, NULL);
   WebPrintf(client, DOCTYPE);
@@ -499,7 +587,7 @@ void SendRebootHTML(WiFiClient *client)
   WebPrintf(client, "</body>");
 }
 
-void SendResetHTML(WiFiClient *client)
+void SendResetHTML(WebWriter *client)
 {
   WebHeaders(client, NULL);
   WebPrintf(client, DOCTYPE);
@@ -508,7 +596,7 @@ void SendResetHTML(WiFiClient *client)
   WebPrintf(client, "</body>");
 }
 
-void SendGoToConfigureHTTPS(WiFiClient *client)
+void SendGoToConfigureHTTPS(WebWriter *client)
 {
   LogPrintf("+SendGoToConfigureHTTPS\n");
   WebHeaders(client, NULL);
@@ -532,15 +620,21 @@ void Reset()
 }
 
 
-void HandleConfigSubmit(WiFiClient *client, char *params)
+// A POSTed form has already been through SetupField(), leaving no params
+void HandleConfigSubmit(WebWriter *client, char *params)
 {
-  ParseSetupForm(params);
+  if (*params) ParseSetupForm(params);
+  if (!ApplySetupForm()) {
+    WebError(client, 503, NULL);
+    return;
+  }
   SaveSettings();
   SendRebootHTML(client);
+  client->end();
   Reset(); // Restarting safer than trying to change wifi/mqtt/etc.
 }
 
-void HandleUpdateSubmit(WiFiClient *client, char *params)
+void HandleUpdateSubmit(WebWriter *client, char *params)
 {
   char *namePtr;
   char *valPtr;
@@ -575,7 +669,7 @@ void HandleUpdateSubmit(WiFiClient *client, char *params)
   }
   bool err = false;
   // Check settings are good
-  if (id < 0 || id >= MAXEVENTS) err = true;
+  if (id < 0 || id > EventCount()) err = true;
   if (settings.use12hr) {
     if (hr < 0 || hr > 12) err = true;
   } else {
@@ -590,16 +684,21 @@ void HandleUpdateSubmit(WiFiClient *client, char *params)
     WebError(client, 400, NULL);
   } else {
     // Update the entry, send refresh page to send back to index
-    settings.event[id].dayMask = mask;
-    settings.event[id].hour = hr + 12 * ampm; // !use12hr => ampm=0, so safe
-    settings.event[id].minute = mn;
-    settings.event[id].action = action;
+    Event e;
+    e.dayMask = mask;
+    e.hour = hr + 12 * ampm; // !use12hr => ampm=0, so safe
+    e.minute = mn;
+    e.action = action;
+    if (!SetEvent(id, &e)) {
+      WebError(client, 507, NULL);
+      return;
+    }
     SaveSettings(); // Store in flash
     SendSuccessHTML(client);
   }
 }
 
-void HandleEditHTML(WiFiClient *client, char *params)
+void HandleEditHTML(WebWriter *client, char *params)
 {
   int id = -1;
   char *namePtr;
@@ -607,7 +706,7 @@ void HandleEditHTML(WiFiClient *client, char *params)
   while (ParseParam(&params, &namePtr, &valPtr)) {
     ParamInt("id", id);
   }
-  if (id >=0 && id < MAXEVENTS) {
+  if (id >=0 && id <= EventCount() && id < MAXEVENTS) {
     SendEditHTML(client, id);
   } else {
     WebError(client, 400, NULL);
@@ -615,7 +714,7 @@ void HandleEditHTML(WiFiClient *client, char *params)
 }
 
 
-void SendOTARedirect(WiFiClient *client)
+void SendOTARedirect(WebWriter *client)
 {
   LogPrintf("+SendOTARedirect\n");
   IPAddress ip = WiFi.localIP();
@@ -629,10 +728,393 @@ void SendOTARedirect(WiFiClient *client)
 
 
 
+// Route handlers, all with the WebHandler signature
+
+// Any HTTP request once configured, send it to https:// on our IP
+void RouteRedirectHTTPS(WebWriter *out, char *url, char *params)
+{
+  LogPrintf("HTTP Redirector request: %s\n", url);
+  char newLoc[64];
+  IPAddress ip = WiFi.localIP();
+  snprintf_P(newLoc, sizeof(newLoc), PSTR("Location: https://%d.%d.%d.%d/%s"), ip[0], ip[1], ip[2], ip[3], url[0]?url:"index.html");
+  WebError(out, 301, newLoc, false);
+}
+
+// Captive portal check, point it at the setup page
+void RouteCaptiveRedirect(WebWriter *out, char *url, char *params)
+{
+  LogPrintf("Sending 301 redirector to https://<>/configure.html\n");
+  char newLoc[64];
+  snprintf_P(newLoc, sizeof(newLoc), PSTR("Location: https://%d.%d.%d.%d/configure.html"), setupIP[0], setupIP[1], setupIP[2], setupIP[3]);
+  WebError(out, 301, newLoc, false);
+}
+
+void RouteGoToConfigure(WebWriter *out, char *url, char *params)
+{
+  LogPrintf("Sending redirector web page listing config https link\n");
+  SendGoToConfigureHTTPS(out);
+}
+
+void RouteNotFound(WebWriter *out, char *url, char *params)
+{
+  WebError(out, 404, NULL);
+}
+
+void RouteSetup(WebWriter *out, char *url, char *params)
+{
+  SendSetupHTML(out);
+}
+
+void RouteConfigSubmit(WebWriter *out, char *url, char *params)
+{
+  HandleConfigSubmit(out, params);
+}
+
+void RouteStatus(WebWriter *out, char *url, char *params)
+{
+  SendStatusHTML(out);
+}
+
+void RouteOn(WebWriter *out, char *url, char *params)
+{
+  PerformAction(ACTION_ON);
+  SendSuccessHTML(out);
+}
+
+void RouteOff(WebWriter *out, char *url, char *params)
+{
+  PerformAction(ACTION_OFF);
+  SendSuccessHTML(out);
+}
+
+void RouteToggle(WebWriter *out, char *url, char *params)
+{
+  PerformAction(ACTION_TOGGLE);
+  SendSuccessHTML(out);
+}
+
+void RoutePulseOff(WebWriter *out, char *url, char *params)
+{
+  PerformAction(ACTION_PULSEOFF);
+  SendSuccessHTML(out);
+}
+
+void RoutePulseOn(WebWriter *out, char *url, char *params)
+{
+  PerformAction(ACTION_PULSEON);
+  SendSuccessHTML(out);
+}
+
+// Optional ?minutes=N, otherwise the configured length
+void RouteOnFor(WebWriter *out, char *url, char *params)
+{
+  char *namePtr;
+  char *valPtr;
+  int mins = 0;
+  while (ParseParam(&params, &namePtr, &valPtr)) {
+    ParamInt("minutes", mins);
+  }
+  if (mins < 0 || mins > 24 * 60) {
+    WebError(out, 400, NULL);
+    return;
+  }
+  PerformAction(ACTION_ONFOR, mins * 60000UL);
+  SendSuccessHTML(out);
+}
+
+void RoutePowerState(WebWriter *out, char *url, char *params)
+{
+  if (WebNotModified(out, RelayGeneration())) return;
+  WebHeaders(out, NULL);
+  WebPrintf(out, "%d", GetRelay()?1:0);
+}
+
+void RouteHang(WebWriter *out, char *url, char *params)
+{
+  SendResetHTML(out);
+  out->end();
+  Reset(); // Restarting safer than trying to change wifi/mqtt/etc.
+}
+
+void RouteEdit(WebWriter *out, char *url, char *params)
+{
+  HandleEditHTML(out, params);
+}
+
+void RouteUpdate(WebWriter *out, char *url, char *params)
+{
+  HandleUpdateSubmit(out, params);
+}
+
+void RouteEnableUpdate(WebWriter *out, char *url, char *params)
+{
+  StopMQTT();
+  otaUpdateServer = new ESP8266HTTPUpdateServer;
+  otaServer = new ESP8266WebServer(8080);
+  otaUpdateServer->setup(otaServer);
+  otaServer->begin();
+  killUpdateTime = millis() + 10*60*1000; // now + 10 mins
+  SendOTARedirect(out);
+}
+
+void RouteStatic(WebWriter *out, char *url, char *params)
+{
+  if (!WebSendStatic(out, url)) WebError(out, 404, NULL);
+}
+
+void RouteEvents(WebWriter *out, char *url, char *params)
+{
+  EventsSubscribe(out);
+}
+
+// Route paths, hashed at compile time and kept in flash
+static constexpr char pathFavicon[] PROGMEM =      "favicon.ico";
+static constexpr char pathGenerate204[] PROGMEM =  "generate_204";
+static constexpr char pathRoot[] PROGMEM =         "";
+static constexpr char pathIndex[] PROGMEM =        "index.html";
+static constexpr char pathConfigure[] PROGMEM =    "configure.html";
+static constexpr char pathConfig[] PROGMEM =       "config.html";
+static constexpr char pathOn[] PROGMEM =           "on.html";
+static constexpr char pathOff[] PROGMEM =          "off.html";
+static constexpr char pathToggle[] PROGMEM =       "toggle.html";
+static constexpr char pathPulseOff[] PROGMEM =     "pulseoff.html";
+static constexpr char pathPulseOn[] PROGMEM =      "pulseon.html";
+static constexpr char pathOnFor[] PROGMEM =        "onfor.html";
+static constexpr char pathStatus[] PROGMEM =       "status.html";
+static constexpr char pathHang[] PROGMEM =         "hang.html";
+static constexpr char pathEdit[] PROGMEM =         "edit.html";
+static constexpr char pathUpdate[] PROGMEM =       "update.html";
+static constexpr char pathReconfig[] PROGMEM =     "reconfig.html";
+static constexpr char pathEnableUpdate[] PROGMEM = "enableupdate.html";
+static constexpr char pathSchedJS[] PROGMEM =      "sched.js";
+static constexpr char pathEvents[] PROGMEM =       "events";
+static constexpr char pathAPIState[] PROGMEM =     "api/v1/state";
+static constexpr char pathAPISchedule[] PROGMEM =  "api/v1/schedule";
+static constexpr char pathAPISettings[] PROGMEM =  "api/v1/settings";
+static constexpr char pathAPIAction[] PROGMEM =    "api/v1/action";
+
+// Every page on every server.  The same path may be listed for several servers.
+static const WebRoute routes[] PROGMEM = {
+  // HTTP once configured, everything goes to HTTPS
+  ROUTE_CATCHALL(WEB_SERVER_REDIRECT, ROUTE_ANY, RouteRedirectHTTPS),
+
+  // HTTP in setup mode, a captive portal
+  ROUTE(pathFavicon,         WEB_SERVER_CAPTIVE, ROUTE_ANY, RouteNotFound),
+  ROUTE(pathGenerate204,     WEB_SERVER_CAPTIVE, ROUTE_ANY, RouteCaptiveRedirect),
+  ROUTE_CATCHALL(WEB_SERVER_CAPTIVE, ROUTE_ANY, RouteGoToConfigure),
+
+  // HTTPS in setup mode
+  ROUTE(pathRoot,            WEB_SERVER_SETUP, ROUTE_ANY, RouteSetup),
+  ROUTE(pathIndex,           WEB_SERVER_SETUP, ROUTE_ANY, RouteSetup),
+  ROUTE(pathConfigure,       WEB_SERVER_SETUP, ROUTE_ANY, RouteSetup),
+  ROUTE_FORM(pathConfig,     WEB_SERVER_SETUP, ROUTE_ANY | ROUTE_PARAMS, SetupField, RouteConfigSubmit),
+  ROUTE_CATCHALL(WEB_SERVER_SETUP, ROUTE_ANY, RouteNotFound),
+
+  // HTTPS once configured
+  ROUTE(pathRoot,            WEB_SERVER_MAIN, ROUTE_ANY | ROUTE_AUTH, RouteStatus),
+  ROUTE(pathIndex,           WEB_SERVER_MAIN, ROUTE_ANY | ROUTE_AUTH, RouteStatus),
+  ROUTE(pathOn,              WEB_SERVER_MAIN, ROUTE_ANY | ROUTE_AUTH, RouteOn),
+  ROUTE(pathOff,             WEB_SERVER_MAIN, ROUTE_ANY | ROUTE_AUTH, RouteOff),
+  ROUTE(pathToggle,          WEB_SERVER_MAIN, ROUTE_ANY | ROUTE_AUTH, RouteToggle),
+  ROUTE(pathPulseOff,        WEB_SERVER_MAIN, ROUTE_ANY | ROUTE_AUTH, RoutePulseOff),
+  ROUTE(pathPulseOn,         WEB_SERVER_MAIN, ROUTE_ANY | ROUTE_AUTH, RoutePulseOn),
+  ROUTE(pathOnFor,           WEB_SERVER_MAIN, ROUTE_ANY | ROUTE_AUTH, RouteOnFor),
+  ROUTE(pathStatus,          WEB_SERVER_MAIN, ROUTE_ANY | ROUTE_AUTH, RoutePowerState),
+  ROUTE(pathHang,            WEB_SERVER_MAIN, ROUTE_ANY | ROUTE_AUTH, RouteHang),
+  ROUTE(pathEdit,            WEB_SERVER_MAIN, ROUTE_ANY | ROUTE_AUTH | ROUTE_PARAMS, RouteEdit),
+  ROUTE(pathUpdate,          WEB_SERVER_MAIN, ROUTE_ANY | ROUTE_AUTH | ROUTE_PARAMS, RouteUpdate),
+  ROUTE(pathReconfig,        WEB_SERVER_MAIN, ROUTE_ANY | ROUTE_AUTH, RouteSetup),
+  ROUTE_FORM(pathConfig,     WEB_SERVER_MAIN, ROUTE_ANY | ROUTE_AUTH | ROUTE_PARAMS, SetupField, RouteConfigSubmit),
+  ROUTE(pathEnableUpdate,    WEB_SERVER_MAIN, ROUTE_ANY | ROUTE_AUTH, RouteEnableUpdate),
+  ROUTE(pathSchedJS,         WEB_SERVER_MAIN, ROUTE_GET, RouteStatic),
+  ROUTE(pathEvents,          WEB_SERVER_MAIN, ROUTE_GET | ROUTE_AUTH | ROUTE_STREAM, RouteEvents),
+  ROUTE(pathAPIState,        WEB_SERVER_MAIN, ROUTE_GET | ROUTE_AUTH, APIGetState),
+  ROUTE(pathAPISchedule,     WEB_SERVER_MAIN, ROUTE_GET | ROUTE_AUTH, APIGetSchedule),
+  ROUTE(pathAPISchedule,     WEB_SERVER_MAIN, ROUTE_POST | ROUTE_AUTH, APIPostSchedule),
+  ROUTE(pathAPISettings,     WEB_SERVER_MAIN, ROUTE_GET | ROUTE_AUTH, APIGetSettings),
+  ROUTE(pathAPIAction,       WEB_SERVER_MAIN, ROUTE_POST | ROUTE_AUTH, APIPostAction),
+  ROUTE_CATCHALL(WEB_SERVER_MAIN, ROUTE_ANY | ROUTE_AUTH, RouteNotFound),
+};
+
+void StartWeb()
+{
+  WebRoutesBegin(routes, sizeof(routes) / sizeof(routes[0]));
+}
+
+
+// Find an unused connection slot
+WebConn *FreeConn()
+{
+  for (int i=0; i<WEB_MAX_CONNS; i++) {
+    if (!conns[i].client) return &conns[i];
+  }
+  return NULL;
+}
+
+// Take at most one new connection from each server into free slots
+void AcceptConns()
+{
+  WebConn *conn = FreeConn();
+  if (!conn && (redirector.hasClient() || https.hasClient())) {
+    // All full, so hang up on a keep-alive connection that's just sitting idle
+    for (int i=0; i<WEB_MAX_CONNS && !conn; i++) {
+      if (conns[i].requests && !conns[i].streaming && WebRequestIdle(&conns[i].req)) {
+        WebConnClose(&conns[i]);
+        conn = &conns[i];
+      }
+    }
+  }
+  if (!conn) return;
+
+  WiFiClient newClient = redirector.available();
+  if (newClient) {
+    LogPrintf("HTTP Redirector available\n");
+    WebConnOpen(conn, new WiFiClient(newClient), false);
+    conn = FreeConn();
+    if (!conn) return;
+  }
+
+  // Each TLS session needs a large chunk of heap.  If MQTT is what's holding it
+  // then pause MQTT, otherwise leave new ones in the backlog until there's room
+  if (ESP.getFreeHeap() < WEB_ACCEPT_MIN_HEAP) {
+    if (https.hasClient()) PauseMQTT();
+    if (ESP.getFreeHeap() < WEB_ACCEPT_MIN_HEAP) return;
+  }
+  WiFiClientSecure newSecure = AcceptHTTPS();
+  if (newSecure) {
+    if (MQTTConnected()) mqttKept++; // Used to be a disconnect and reconnect
+    WebConnOpen(conn, new WiFiClientSecure(newSecure), true);
+  }
+}
+
+// Which of our servers a connection is talking to
+static byte ConnServer(WebConn *conn)
+{
+  if (!conn->secure) return isSetup ? WEB_SERVER_REDIRECT : WEB_SERVER_CAPTIVE;
+  return isSetup ? WEB_SERVER_MAIN : WEB_SERVER_SETUP;
+}
+
+// Parse whatever has arrived on a connection
+static int ReadConn(WebConn *conn, char **url, char **params, bool *keepAlive)
+{
+  int ret = WebReadRequest(conn->client, &conn->req, url, params, keepAlive);
+  // Only the configured HTTPS server keeps connections open
+  if (ConnServer(conn) != WEB_SERVER_MAIN || conn->requests + 1 >= WEB_KEEPALIVE_MAXREQ) *keepAlive = false;
+  return ret;
+}
+
+// Find and authorize the route for a request whose headers are in, before any body is read.
+// Sends the error and returns false if it can't be served.
+static bool RouteConn(WebConn *conn, char *url, bool keepAlive)
+{
+  WebRequest *req = &conn->req;
+  // An unread body would be taken for the next request, so errors hang up on one
+  if (WebRequestPost(req) && req->bodyLeft > 0) keepAlive = false;
+
+  WebWriter out(conn->client);
+  out.setKeepAlive(keepAlive);
+  int found = WebFindRoute(url, ConnServer(conn), WebRequestPost(req), &conn->route);
+  if (found == WEBROUTE_NOTFOUND) {
+    WebError(&out, 404, NULL);
+  } else if ((conn->route.flags & ROUTE_AUTH) && !WebAuthenticate(&out, req, settings.uiUser, settings.uiSalt, settings.uiPassEnc)) {
+    // 401 was sent
+  } else if (found == WEBROUTE_BADMETHOD) {
+    WebError(&out, 405, (conn->route.flags & ROUTE_POST) ? PSTR("Allow: POST") : PSTR("Allow: GET"));
+  } else {
+    return true;
+  }
+  return false;
+}
+
+// Advance one connection: parse what's arrived and answer it if the request is complete
+void ServiceConn(WebConn *conn)
+{
+  char *url;
+  char *params;
+  bool keepAlive = false;
+
+  if (!conn->client->connected() && !conn->client->available()) {
+    if (conn->streaming) EventsUnsubscribe(conn->client);
+    WebConnClose(conn);
+    return;
+  }
+
+  if (conn->streaming) {
+    // Nothing more is expected from an event stream client, toss anything it sends
+    while (conn->client->available()) conn->client->read();
+    return;
+  }
+
+  int ret = ReadConn(conn, &url, &params, &keepAlive);
+  if (ret == WEBREQ_HEADERS) {
+    // Routed before the body arrives so a form can go straight to its field handler
+    if (RouteConn(conn, url, keepAlive)) {
+      if (conn->route.field) WebRequestForm(&conn->req, conn->route.field);
+      ret = ReadConn(conn, &url, &params, &keepAlive);
+    } else {
+      ret = WEBREQ_FAILED;
+      if (WebRequestPost(&conn->req) && conn->req.bodyLeft > 0) keepAlive = false;
+    }
+  }
+
+  if (ret == WEBREQ_READY) {
+    WebRequest *req = &conn->req;
+    WebWriter out(conn->client);
+    out.setKeepAlive(keepAlive);
+    out.setGzipOK(req->gzipOK);
+    if (req->etag[0]) out.setIfNoneMatch(req->etag);
+    if (req->newSession) out.setSession(req->sessBuff);
+    bool streamed = req->streamForm && req->form.fields;
+    if ((conn->route.flags & ROUTE_PARAMS) && !*params && !streamed) {
+      WebError(&out, 404, NULL);
+    } else {
+      if (ConnServer(conn) == WEB_SERVER_MAIN) webRequests++;
+      conn->route.handler(&out, url, params);
+      keepAlive = out.keepAlive(); // The handler may have decided to close, e.g. an error with no framing
+      // Event streams keep the slot until the client hangs up
+      if (conn->route.flags & ROUTE_STREAM) conn->streaming = EventsSubscribed(conn->client);
+    }
+  }
+
+  if (ret == WEBREQ_PENDING) return;
+  if (ret == WEBREQ_READY) WebConnServed(conn);
+  if (conn->streaming) {
+    // Stays open for EventsPublish()
+  } else if (keepAlive) {
+    WebRequestBegin(&conn->req);
+  } else {
+    WebConnClose(conn);
+  }
+}
+
+
+// Nothing to service until a new connection, more of a request, a button press or a deadline, so let
+// the rest of this pass go.  delay() hands the time to the SDK, which idles the CPU and (in modem sleep) the radio
+static void IdleLoop()
+{
+  if (otaServer || redirector.hasClient() || https.hasClient()) return;
+  for (int i=0; i<WEB_MAX_CONNS; i++) {
+    WebConn *conn = &conns[i];
+    if (!conn->client || conn->streaming) continue;
+    if (!WebRequestIdle(&conn->req) || conn->client->available()) return; // Partway through a request
+  }
+
+  long ms = LOOP_IDLE_MS;
+  long timer = NextTimerMS();
+  if (timer >= 0 && timer < ms) ms = timer;
+  if (isSetup && timeStatus() != timeNotSet) {
+    time_t due = NextScheduleUTC();
+    if (due && due <= now()) ms = 0;
+  }
+  if (ms > 0) {
+    delay(ms);
+    idleMS += ms;
+  }
+}
+
 void loop()
 {
   static unsigned long lastMS = 0;
-  static unsigned long killUpdateTime = 0;
 
   // Time to restart the plug if the update window is over
   if (killUpdateTime && (millis() > killUpdateTime) ) {
@@ -650,116 +1132,31 @@ void loop()
   // Let the button toggle the relay always
   ManageButton();
 
+  // Relay pulses and countdowns run even before setup is done
+  ManageTimers();
+
   // Blink the LED appropriate to the state
   ManageLED(isSetup ? LED_CONNECTED : LED_AWAITSETUP);
 
   // Pump DNS queue
   if (!isSetup) {
     ManageDNS();
-  }
-  
-  char *url;
-  char *params;
-
-  // Any HTTP request, send it to https:// on our IP
-  WiFiClient redir = redirector.available();
-  if (redir) {
-    LogPrintf("HTTP Redirector available\n");
-    if (WebReadRequest(&redir, &url, &params, false)) {
-      LogPrintf("HTTP Redirector request: %s\n", url);
-      char newLoc[64];
-      if (isSetup) {
-        IPAddress ip = WiFi.localIP();
-        snprintf_P(newLoc, sizeof(newLoc), PSTR("Location: https://%d.%d.%d.%d/%s"), ip[0], ip[1], ip[2], ip[3], url[0]?url:"index.html");
-        WebError(&redir, 301, newLoc, false);
-      } else {
-        if (!strcmp_P(url, PSTR("favicon.ico"))) {
-          WebError(&redir, 404, NULL);
-        } else if (!strcmp_P(url, PSTR("generate_204"))) {
-          LogPrintf("Sending 301 redirector to https://<>/configure.html\n");
-          snprintf_P(newLoc, sizeof(newLoc), PSTR("Location: https://%d.%d.%d.%d/configure.html"), setupIP[0], setupIP[1], setupIP[2], setupIP[3]);
-          WebError(&redir, 301, newLoc, false);
-        } else {
-          LogPrintf("Sending redirector web page listing config https link\n");
-          SendGoToConfigureHTTPS(&redir);
-          LogPrintf("Sent\n");
-        }
-      }
-      redir.flush();
-      redir.stop();
-      LogPrintf("redir.stop()\n");
-    }
-  } else if (!isSetup) {
-    WiFiClientSecure client = https.available();
-    if (client) {
-      LogPrintf("+HTTPS setup request\n");
-      if (WebReadRequest(&client, &url, &params, false)) {
-        Serial.printf("url: '%s'\n", url);
-        if (IsIndexHTML(url) || !strcmp_P(url, PSTR("configure.html"))) {
-          SendSetupHTML(&client);
-        } else if (!strcmp_P(url, PSTR("config.html")) && *params) {
-          HandleConfigSubmit(&client, params);
-        } else {
-          WebError(&client, 404, NULL);
-        }
-      }
-      client.flush();
-      client.stop();
-      LogPrintf("-HTTPS setup request\n");
-    }
   } else {
     if (!otaServer) ManageMQTT();
     ManageSchedule();
     ManagePowerMonitor();
+    ManageEvents();
+  }
 
-    WiFiClientSecure client = https.available();
-    if (client) {
-      StopMQTT(); //
-      if (WebReadRequest(&client, &url, &params, true, settings.uiUser, settings.uiSalt, settings.uiPassEnc)) {
-        if (IsIndexHTML(url)) {
-          SendStatusHTML(&client);
-        } else if (!strcmp_P(url, PSTR("on.html"))) {
-          PerformAction(ACTION_ON);
-          SendSuccessHTML(&client);
-        } else if (!strcmp_P(url, PSTR("off.html"))) {
-          PerformAction(ACTION_OFF);
-          SendSuccessHTML(&client);
-        } else if (!strcmp_P(url, PSTR("toggle.html"))) {
-          PerformAction(ACTION_TOGGLE);
-          SendSuccessHTML(&client);
-        } else if (!strcmp_P(url, PSTR("pulseoff.html"))) {
-          PerformAction(ACTION_PULSEOFF);
-          SendSuccessHTML(&client);
-        } else if (!strcmp_P(url, PSTR("pulseon.html"))) {
-          PerformAction(ACTION_PULSEON);
-          SendSuccessHTML(&client);
-        } else if (!strcmp_P(url, PSTR("status.html"))) {
-          WebPrintf(&client, "%d", GetRelay()?1:0);
-        } else if (!strcmp_P(url, PSTR("hang.html"))) {
-          SendResetHTML(&client);
-          Reset(); // Restarting safer than trying to change wifi/mqtt/etc.
-        } else if (!strcmp_P(url, PSTR("edit.html")) && *params) {
-          HandleEditHTML(&client, params);
-        } else if (!strcmp_P(url, PSTR("update.html")) && *params) {
-          HandleUpdateSubmit(&client, params);
-        } else if (!strcmp_P(url, PSTR("reconfig.html"))) {
-          SendSetupHTML(&client);
-        } else if (!strcmp_P(url, PSTR("config.html")) && *params) {
-          HandleConfigSubmit(&client, params);
-        } else if (!strcmp_P(url, PSTR("enableupdate.html"))) {
-          StopMQTT();
-          otaUpdateServer = new ESP8266HTTPUpdateServer;
-          otaServer = new ESP8266WebServer(8080);
-          otaUpdateServer->setup(otaServer);
-          otaServer->begin();
-          killUpdateTime = millis() + 10*60*1000; // now + 10 mins
-          SendOTARedirect(&client);
-        } else {
-          WebError(&client, 404, NULL);
-        }
-      }
-      client.flush();
-      client.stop();
-    }
+  AcceptConns();
+
+  // Give every open connection a turn, rotating who goes first
+  static int nextConn = 0;
+  for (int i=0; i<WEB_MAX_CONNS; i++) {
+    WebConn *conn = &conns[(nextConn + i) % WEB_MAX_CONNS];
+    if (conn->client) ServiceConn(conn);
   }
+  nextConn = (nextConn + 1) % WEB_MAX_CONNS;
+
+  IdleLoop();
 }
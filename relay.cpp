@@ -22,9 +22,25 @@
 #include "relay.h"
 #include "mqtt.h"
 #include "log.h"
+#include "timer.h"
 
 #define PIN_RELAY (15)
 
+static uint32_t relayGeneration = 0;
+static int relayTimer = 0; // Pending flip back from SetRelayFor()
+
+static void WriteRelay(bool on)
+{
+  if (on != GetRelay()) relayGeneration++;
+  digitalWrite(PIN_RELAY, on ? HIGH:LOW );
+  MQTTPublishInt("powerstate", on ? 1 : 0);
+}
+
+static void RelayTimerDone(int on)
+{
+  relayTimer = 0;
+  WriteRelay(on ? true : false);
+}
 
 // Initializes relay control pins (relay state undefined)
 void StartRelay(bool state)
@@ -36,8 +52,22 @@ void StartRelay(bool state)
 // Sets the relay on or off and handles any logging required
 void SetRelay(bool on)
 {
-  digitalWrite(PIN_RELAY, on ? HIGH:LOW );
-  MQTTPublishInt("powerstate", on ? 1 : 0);
+  CancelTimer(&relayTimer);
+  WriteRelay(on);
+}
+
+// Sets the relay and flips it back after ms, unless something else sets it first
+void SetRelayFor(bool on, unsigned long ms)
+{
+  SetRelay(on);
+  relayTimer = StartTimer(ms, RelayTimerDone, on ? 0 : 1);
+  if (!relayTimer) LogPrintf("No timer free, relay left %s\n", on ? "on" : "off");
+}
+
+// ms until a SetRelayFor() flips the relay back, or -1 if it won't
+long RelayTimeLeft()
+{
+  return TimerMSLeft(relayTimer);
 }
 
 // Returns relay state
@@ -46,3 +76,7 @@ bool GetRelay()
   return digitalRead(PIN_RELAY)==LOW?false:true;
 }
 
+uint32_t RelayGeneration()
+{
+  return relayGeneration;
+}
@@ -27,8 +27,15 @@ void StartRelay(bool state);
 // Sets the relay on or off and handles any logging required
 void SetRelay(bool on);
 
+// Sets the relay on or off, then back again after ms.  Any other change cancels the flip back
+void SetRelayFor(bool on, unsigned long ms);
+long RelayTimeLeft(); // ms until the flip back, -1 if none pending
+
 // Returns current state of relay
 bool GetRelay();
 
+// Bumped every time the relay changes state, for cache validation
+uint32_t RelayGeneration();
+
 #endif
 
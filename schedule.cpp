@@ -18,6 +18,11 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+// Scheduled actions.  Build a host simulator that replays years of clock time, DST changes and NTP
+// jumps through the real LocalTime() and checks every action fired with:
+//   g++ -DTEST_SCHEDULE -DTEST_TIMEZONE -O2 -o schedtest schedule.cpp timezone.cpp && ./schedtest
+
+#ifndef TEST_SCHEDULE
 #include <Arduino.h>
 #include <TimeLib.h>
 #include "psychoplug.h"
@@ -26,6 +31,34 @@
 #include "mqtt.h"
 #include "relay.h"
 #include "timezone.h"
+#include "log.h"
+#else
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+typedef uint8_t byte;
+#define PSTR(x) (x)
+#define strncpy_P strncpy
+#define LogPrintf(...) printf(__VA_ARGS__)
+#define SECS_PER_DAY (60*60*24)
+typedef enum { timeNotSet, timeNeedsSync, timeSet } timeStatus_t;
+#include "schedule.h"
+
+// Just enough of the rest of the firmware for the schedule to run against, defined with the simulator
+static struct { uint16_t pulseMS; uint16_t onForMins; } settings = { 2000, 60 };
+static uint32_t SettingsGeneration();
+static time_t now();
+static timeStatus_t timeStatus();
+static void SetRelay(bool on);
+static bool GetRelay();
+static void SetRelayFor(bool on, unsigned long ms);
+static void MQTTPublish(const char *key, const char *value);
+time_t LocalTime(time_t whenUTC);
+time_t NextOffsetChange(time_t whenUTC);
+bool SetTZ(const char *tzName);
+#endif
 
 
 char *GetActionString(int idx, char *str, int len) {
@@ -36,12 +69,13 @@ char *GetActionString(int idx, char *str, int len) {
     case 3 : strncpy_P(str, PSTR("Toggle"), len); break;
     case 4 : strncpy_P(str, PSTR("Pulse Off"), len); break;
     case 5 : strncpy_P(str, PSTR("Pulse On"), len); break;
+    case 6 : strncpy_P(str, PSTR("On For Time"), len); break;
     default: strncpy_P(str, PSTR("Invalid"), len); break;
   }
   return str;
 }
 
-void PerformAction(int action)
+void PerformAction(int action, unsigned long ms)
 {
   if (action != ACTION_NONE) {
     char str[16];
@@ -53,66 +87,507 @@ void PerformAction(int action)
     case ACTION_ON: SetRelay(true); break;
     case ACTION_OFF: SetRelay(false); break;
     case ACTION_TOGGLE: SetRelay(!GetRelay()); break;
-    case ACTION_PULSEOFF: SetRelay(false); delay(2000); SetRelay(true); break;
-    case ACTION_PULSEON: SetRelay(true); delay(2000); SetRelay(false); break;
+    case ACTION_PULSEOFF: SetRelayFor(false, ms ? ms : settings.pulseMS); break;
+    case ACTION_PULSEON: SetRelayFor(true, ms ? ms : settings.pulseMS); break;
+    case ACTION_ONFOR: SetRelayFor(true, ms ? ms : settings.onForMins * 60000UL); break;
   }
   
 }
 
 
-// Handle automated on/off simply on the assumption we don't lose any minutes
-static char lastHour = 25;
-static char lastMin = -1;
-static char lastDOW = -1;
+// The event list, grown as needed so a plug with a handful of rules doesn't pay for MAXEVENTS
+static Event *events = NULL;
+static int eventCount = 0;
+static int eventAlloc = 0;
+static bool schedBuilt = false; // Index below matches the list
+
+int EventCount()
+{
+  return eventCount;
+}
+
+const Event *GetEvent(int id)
+{
+  return (id >= 0 && id < eventCount) ? &events[id] : NULL;
+}
+
+bool SetEvent(int id, const Event *e)
+{
+  if (id < 0 || id > eventCount) return false;
+  schedBuilt = false;
+  if (e->action == ACTION_NONE) {
+    if (id == eventCount) return true; // Nothing to add
+    memmove(&events[id], &events[id+1], (eventCount - id - 1) * sizeof(Event));
+    eventCount--;
+    return true;
+  }
+  if (id == eventCount) {
+    if (eventCount == MAXEVENTS) return false;
+    if (eventCount == eventAlloc) {
+      int newAlloc = eventAlloc ? eventAlloc * 2 : 8;
+      if (newAlloc > MAXEVENTS) newAlloc = MAXEVENTS;
+      Event *newEvents = (Event *)realloc(events, newAlloc * sizeof(Event));
+      if (!newEvents) return false;
+      events = newEvents;
+      eventAlloc = newAlloc;
+    }
+    eventCount++;
+  }
+  events[id] = *e;
+  return true;
+}
+
+void ClearEvents()
+{
+  schedBuilt = false;
+  free(events);
+  events = NULL;
+  eventCount = 0;
+  eventAlloc = 0;
+}
+
+
+// Every active event, sorted by minute of the day.  Rebuilt whenever the settings are saved, so
+// catching up after a time jump is a range lookup that checks each match's dayMask.  Each entry
+// is (minute of day << 16) | event, so ties sort in event order and the highest numbered one wins
+#define MINSPERDAY (24 * 60)
+#define MINSPERWEEK (7 * MINSPERDAY)
+static uint32_t *sched = NULL;
+static int schedCount = 0;
+static uint32_t schedGeneration = 0;
+static bool schedNoMem = false; // Last build failed, already logged
+
+#define SchedMOD(i)   ((int)(sched[i] >> 16))
+#define SchedEvent(i) (&events[sched[i] & 0xffff])
+
+static int MinuteOfWeek(time_t local)
+{
+  long days = local / SECS_PER_DAY;
+  int dow = (days + 4) % 7; // 1/1/1970 was a Thursday
+  return dow * MINSPERDAY + (local % SECS_PER_DAY) / 60;
+}
+
+static int CompareSched(const void *a, const void *b)
+{
+  uint32_t x = *(const uint32_t *)a;
+  uint32_t y = *(const uint32_t *)b;
+  return (x < y) ? -1 : (x > y) ? 1 : 0;
+}
+
+// False if there wasn't the memory, in which case the old index is gone and it's tried again next time
+static bool BuildScheduleIndex()
+{
+  int slots = 0;
+  for (int i=0; i<eventCount; i++) {
+    if (events[i].dayMask) slots++;
+  }
+  free(sched);
+  sched = slots ? (uint32_t *)malloc(slots * sizeof(uint32_t)) : NULL;
+  schedCount = 0;
+  if (slots && !sched) {
+    if (!schedNoMem) LogPrintf("Schedule: Unable to allocate %d byte index\n", slots * (int)sizeof(uint32_t));
+    schedNoMem = true;
+    schedBuilt = false;
+    return false;
+  }
+  schedNoMem = false;
+
+  for (int i=0; i<eventCount; i++) {
+    if (!events[i].dayMask) continue;
+    uint32_t mod = events[i].hour * 60 + events[i].minute;
+    sched[schedCount++] = (mod << 16) | i;
+  }
+  if (schedCount) qsort(sched, schedCount, sizeof(uint32_t), CompareSched);
+  schedGeneration = SettingsGeneration();
+  schedBuilt = true;
+  return true;
+}
+
+static bool ScheduleIndexOK()
+{
+  if (schedBuilt && schedGeneration == SettingsGeneration()) return true;
+  return BuildScheduleIndex();
+}
+
+// Number of index entries at or before the given minute of the day
+static int ScheduleUpperBound(int mod)
+{
+  int lo = 0;
+  int hi = schedCount;
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    if (SchedMOD(mid) <= mod) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+// Index entry of the last event in (fromMOW, toMOW], wrapping past the end of the week and
+// covering the whole week when they're equal.  Walks back a day at a time from toMOW.  -1 if none
+static int LastEventBetween(int fromMOW, int toMOW)
+{
+  int left = (toMOW - fromMOW + MINSPERWEEK) % MINSPERWEEK;
+  if (!left) left = MINSPERWEEK;
+  int dow = toMOW / MINSPERDAY;
+  int hi = toMOW % MINSPERDAY;
+  while (left > 0) {
+    int lo = (hi - left + 1 > 0) ? hi - left + 1 : 0;
+    for (int i = ScheduleUpperBound(hi) - 1; i >= 0 && SchedMOD(i) >= lo; i--) {
+      if (SchedEvent(i)->dayMask & (1<<dow)) return i;
+    }
+    left -= hi - lo + 1;
+    dow = (dow + 6) % 7;
+    hi = MINSPERDAY - 1;
+  }
+  return -1;
+}
+
+// Local time of the next scheduled event after the given local time, 0 if there are none
+time_t NextEventAt(time_t local, int *action)
+{
+  if (!ScheduleIndexOK() || !schedCount) return 0;
+  int mow = MinuteOfWeek(local);
+  int dow = mow / MINSPERDAY;
+  int mod = mow % MINSPERDAY;
+  // Rest of today, then each following day up to and including this one next week
+  for (int day=0; day<=7; day++) {
+    int d = (dow + day) % 7;
+    for (int i = day ? 0 : ScheduleUpperBound(mod); i < schedCount; i++) {
+      if (!(SchedEvent(i)->dayMask & (1<<d))) continue;
+      if (action) *action = SchedEvent(i)->action;
+      return local - (local % 60) + (day * MINSPERDAY + SchedMOD(i) - mod) * 60;
+    }
+  }
+  return 0; // Events exist, but none are on any day
+}
+
+// Handle automated on/off.  Any minutes skipped since the last call (NTP corrections, slow loops)
+// are caught up, and only the last action due is performed even if several were.  When the clock
+// goes back a little (DST ending, NTP setting it back) nothing fires until it passes where it was,
+// so a repeated hour only runs its events once.  Further back than that and it starts over
+#define SCHEDULE_MAXBACK (3 * 60)
+static long lastMin = -1; // Local minutes since 1970 last checked, -1 before the first check
+// Nothing can be due in [checkedUTC, nextCheckUTC), so calls in between return straight away.
+// Going back past checkedUTC (an NTP correction) means working it out again
+static time_t checkedUTC = 0;
+static time_t nextCheckUTC = 0;
 void ManageSchedule()
 { 
   // Can't run schedule if we don't know what the time is!
   if (timeStatus() == timeNotSet) return;
 
-  // Sane startup time values
-  if (lastHour == 25) {
-    time_t t = LocalTime(now());
-    lastHour = hour(t);
-    lastMin = minute(t);
-    lastDOW = weekday(t) - 1; // We 0-index, weekday() 1-indexes
-  }
-
-  // If this is a new h/m/dow then go through all events and see if we need to do an action.
-  // Only execute after we scan everything, so only last action done once even if there are
-  // multiple entries for the same time or multiple times scanned.
-
-  time_t t = LocalTime(now());
-  int newHour = hour(t);
-  int newMin = minute(t);
-  int newDOW = weekday(t)-1;
-  if (newHour != lastHour || newMin != lastMin || newDOW != lastDOW) {
-    int action = ACTION_NONE;
-    // This *should* be fast unless we lose a day somewhere (NTP problems?)
-    while (newHour != lastHour || newMin != lastMin || newDOW != lastDOW) {
-      lastMin++;
-      if (lastMin==60) { lastHour++; lastMin = 0; }
-      if (lastHour==24) { delay(1); /* allow ctx switch */ lastDOW++; lastHour = 0; }
-      if (lastDOW==7) lastDOW = 0; // Sat->Sun
-      for (int i=0; i<MAXEVENTS; i++) {
-        if ((settings.event[i].dayMask & (1<<lastDOW)) && (settings.event[i].hour == lastHour) && (settings.event[i].minute == lastMin) && (settings.event[i].action != ACTION_NONE)) {
-          action = settings.event[i].action;
-        }
-      }
-    }
+  time_t t = now();
+  bool changed = !schedBuilt || schedGeneration != SettingsGeneration();
+  if (!changed && t >= checkedUTC && t < nextCheckUTC) return;
+  // No index, so leave lastMin alone and catch up once there's memory for one
+  if (changed && !BuildScheduleIndex()) return;
 
-    PerformAction(action);
-
-    lastHour = hour(t);
-    lastMin = minute(t);
-    lastDOW = weekday(t)-1; // Sunday=1 for weekday(), we need 0-index
+  time_t local = LocalTime(t);
+  long min = local / 60;
+  if (lastMin < 0 || min < lastMin - SCHEDULE_MAXBACK) lastMin = min;
+  if (min > lastMin) {
+    // A week or more skipped is just the whole week
+    int mow = MinuteOfWeek(local);
+    int idx = LastEventBetween((min - lastMin >= MINSPERWEEK) ? mow : MinuteOfWeek((time_t)lastMin * 60), mow);
+    lastMin = min;
+    if (idx >= 0) PerformAction(SchedEvent(idx)->action);
   }
+
+  // Sleep until the next event's minute, at today's offset, unless the offset changes first.
+  // With no events, just look again in a day
+  time_t next = NextEventAt((time_t)lastMin * 60, NULL);
+  time_t due = next ? t + (next - local) : t + SECS_PER_DAY;
+  time_t change = NextOffsetChange(t);
+  if (change && change < due) due = change;
+  checkedUTC = t;
+  nextCheckUTC = due;
+}
+
+time_t NextScheduleUTC()
+{
+  return nextCheckUTC;
 }
 
 void StopSchedule()
 {
   // Cause new time to be retrieved.
-  lastHour = -1;
   lastMin = -1;
-  lastDOW = -1;
+  nextCheckUTC = 0;
 }
 
+
+#ifdef TEST_SCHEDULE
+extern bool tzQuiet;
+
+static time_t simNow = 0;
+static bool simRelay = false;
+static uint32_t simGeneration = 1;
+static int simFired = ACTION_NONE; // What the last ManageSchedule() call did
+
+static time_t now() { return simNow; }
+static timeStatus_t timeStatus() { return timeSet; }
+static void SetRelay(bool on) { simRelay = on; }
+static bool GetRelay() { return simRelay; }
+static void SetRelayFor(bool on, unsigned long /*ms*/) { simRelay = on; }
+static uint32_t SettingsGeneration() { return simGeneration; }
+
+static void MQTTPublish(const char * /*key*/, const char *value)
+{
+  char str[16];
+  for (int i=0; i<=ACTION_MAX; i++) {
+    if (!strcmp(value, GetActionString(i, str, sizeof(str)))) simFired = i;
+  }
+}
+
+// The host's zoneinfo, as an independent check on LocalTime()
+static time_t RefLocal(time_t utc)
+{
+  struct tm t;
+  localtime_r(&utc, &t);
+  return utc + t.tm_gmtoff;
+}
+
+// The original minute-by-minute scan: the last action due in local minutes (fromMin, toMin]
+static int RefAction(long fromMin, long toMin)
+{
+  int action = ACTION_NONE;
+  if (toMin - fromMin > MINSPERWEEK) fromMin = toMin - MINSPERWEEK;
+  for (long m = fromMin + 1; m <= toMin; m++) {
+    time_t t = (time_t)m * 60;
+    struct tm q;
+    gmtime_r(&t, &q);
+    for (int i=0; i<EventCount(); i++) {
+      const Event *e = GetEvent(i);
+      if ((e->dayMask & (1<<q.tm_wday)) && e->hour == q.tm_hour && e->minute == q.tm_min) action = e->action;
+    }
+  }
+  return action;
+}
+
+static double NowNS()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void AddEvent(byte dayMask, byte hour, byte minute, byte action)
+{
+  Event e = { dayMask, hour, minute, action };
+  SetEvent(EventCount(), &e);
+  simGeneration++;
+}
+
+// Clock corrections to replay, seconds after the start of the run
+typedef struct {
+  long at;
+  long jump;
+} NTPJump;
+static const NTPJump ntpJumps[] = {
+  { 40 * SECS_PER_DAY + 3600, 7 * 60 }, // A few minutes lost
+  { 100 * SECS_PER_DAY + 7200, -3 * 60 }, // Ran fast, NTP sets it back
+  { 150 * SECS_PER_DAY, 2 * SECS_PER_DAY }, // Powered off for two days
+  { 200 * SECS_PER_DAY + 5 * 3600, -3600 }, // Back an hour
+  { 220 * SECS_PER_DAY + 9 * 3600, -SECS_PER_DAY }, // Set a day ahead by hand, NTP fixes it
+  { 250 * SECS_PER_DAY + 600, 9 * SECS_PER_DAY }, // Powered off for more than a week
+};
+
+typedef struct {
+  long calls;
+  long fired;
+  long mismatches;
+  long minutes;
+  double ns; // Total time in ManageSchedule()
+} SimStats;
+
+// Move the clock on like a few seconds of loop(), with any NTP jumps that are due
+static void SimStep(time_t start, unsigned int *nextJump)
+{
+  simNow += 1 + rand() % 20;
+  if (*nextJump < sizeof(ntpJumps)/sizeof(ntpJumps[0]) && simNow - start >= ntpJumps[*nextJump].at) {
+    simNow += ntpJumps[(*nextJump)++].jump;
+  }
+}
+
+// Wall time for the same clock steps as Simulate(), with or without calling ManageSchedule().
+// The difference between the two is what the calls cost, without timing each one
+static volatile time_t simSink;
+static double TimeSteps(time_t start, time_t end, int year, bool ntp, bool call)
+{
+  StopSchedule();
+  simNow = start;
+  srand(year);
+  unsigned int nextJump = ntp ? 0 : sizeof(ntpJumps)/sizeof(ntpJumps[0]);
+  double t0 = NowNS();
+  while (simNow < end) {
+    SimStep(start, &nextJump);
+    if (call) ManageSchedule();
+    simSink = simNow;
+  }
+  return NowNS() - t0;
+}
+
+// Run the loop() from 1/1 of the year for a year and a week, a few seconds a pass, comparing
+// every action fired against the reference.  Fired actions are logged to log[] if given
+static void Simulate(const char *zone, int year, SimStats *st, time_t *logWhen, int *logAction, int logMax, bool ntp)
+{
+  setenv("TZ", zone, 1);
+  tzset();
+  SetTZ(zone);
+  struct tm t;
+  memset(&t, 0, sizeof(t));
+  t.tm_year = year - 1900;
+  t.tm_mday = 1;
+  time_t start = timegm(&t);
+  time_t end = start + 372 * SECS_PER_DAY;
+
+  memset(st, 0, sizeof(*st));
+  StopSchedule();
+  simNow = start;
+  srand(year);
+  unsigned int nextJump = ntp ? 0 : sizeof(ntpJumps)/sizeof(ntpJumps[0]);
+  long refLast = -1;
+  while (simNow < end) {
+    SimStep(start, &nextJump);
+    simFired = ACTION_NONE;
+    ManageSchedule();
+    st->calls++;
+
+    // Waits out the clock going back a few hours, starts over if it's more
+    long localMin = RefLocal(simNow) / 60;
+    if (refLast < 0 || localMin < refLast - SCHEDULE_MAXBACK) refLast = localMin;
+    int expect = ACTION_NONE;
+    if (localMin > refLast) {
+      expect = RefAction(refLast, localMin);
+      refLast = localMin;
+    }
+
+    if (simFired != ACTION_NONE) {
+      if (st->fired < logMax) {
+        logWhen[st->fired] = simNow;
+        logAction[st->fired] = simFired;
+      }
+      st->fired++;
+    }
+    if (simFired != expect) {
+      char a[16], b[16];
+      time_t local = RefLocal(simNow);
+      struct tm q;
+      gmtime_r(&local, &q);
+      if (st->mismatches < 10) {
+        printf("  %s %04d-%02d-%02d %02d:%02d:%02d local: fired %s, expected %s\n", zone, q.tm_year+1900, q.tm_mon+1, q.tm_mday,
+               q.tm_hour, q.tm_min, q.tm_sec, GetActionString(simFired, a, sizeof(a)), GetActionString(expect, b, sizeof(b)));
+      }
+      st->mismatches++;
+    }
+  }
+  st->minutes = (end - start) / 60;
+
+  // Best of a few runs each way, so a busy host doesn't count against either
+  double with = 0, without = 0;
+  for (int i=0; i<5; i++) {
+    double w = TimeSteps(start, end, year, ntp, true);
+    double wo = TimeSteps(start, end, year, ntp, false);
+    if (!i || w < with) with = w;
+    if (!i || wo < without) without = wo;
+  }
+  st->ns = with - without;
+}
+
+static void PrintStats(const char *what, const SimStats *st)
+{
+  printf("%-40s %6ld fired, %ld mismatches, %.1f ns per simulated minute (%.1f ns per call)\n", what, st->fired, st->mismatches,
+         st->ns / st->minutes, st->ns / st->calls);
+}
+
+// Count the actions logged on a local date, optionally only at one local time
+static int FiredOn(const time_t *logWhen, const int *logAction, long n, int action, int year, int mon, int day, int hr, int mn)
+{
+  int count = 0;
+  for (long i=0; i<n; i++) {
+    time_t local = RefLocal(logWhen[i]);
+    struct tm q;
+    gmtime_r(&local, &q);
+    if (logAction[i] != action || q.tm_year+1900 != year || q.tm_mon+1 != mon || q.tm_mday != day) continue;
+    if (hr >= 0 && (q.tm_hour != hr || q.tm_min != mn)) continue;
+    count++;
+  }
+  return count;
+}
+
+static bool Check(const char *what, int got, int expect)
+{
+  if (got == expect) return true;
+  printf("FAIL %s: %d, expected %d\n", what, got, expect);
+  return false;
+}
+
+// A typical week of rules, including ones inside the hours DST skips and repeats
+static bool CheckRules()
+{
+  ClearEvents();
+  AddEvent(0x3e, 7, 30, ACTION_ON); // Weekdays
+  AddEvent(0x3e, 22, 0, ACTION_OFF);
+  AddEvent(0x01, 2, 30, ACTION_TOGGLE); // Sunday, in the spring-forward gap
+  AddEvent(0x01, 1, 30, ACTION_PULSEON); // Sunday, in the repeated fall-back hour
+  AddEvent(0x40, 23, 59, ACTION_OFF); // Week wraps between these two
+  AddEvent(0x01, 0, 0, ACTION_ON);
+  AddEvent(0x7f, 12, 0, ACTION_ONFOR);
+  AddEvent(0x7f, 12, 0, ACTION_PULSEOFF); // Same minute, the later rule wins
+
+  static time_t logWhen[4096];
+  static int logAction[4096];
+  bool ok = true;
+  SimStats st;
+  Simulate("America/New_York", 2021, &st, logWhen, logAction, 4096, false);
+  PrintStats("America/New_York 2021", &st);
+  ok &= !st.mismatches;
+  ok &= Check("Toggle at 3:00 on 3/14 (2:30 doesn't exist)", FiredOn(logWhen, logAction, st.fired, ACTION_TOGGLE, 2021, 3, 14, 3, 0), 1);
+  ok &= Check("Pulse On once on 11/7 (1:30 happens twice)", FiredOn(logWhen, logAction, st.fired, ACTION_PULSEON, 2021, 11, 7, -1, -1), 1);
+  ok &= Check("On For Time never (Pulse Off wins)", FiredOn(logWhen, logAction, st.fired, ACTION_ONFOR, 2021, 6, 1, -1, -1), 0);
+  ok &= Check("Pulse Off at noon 6/1", FiredOn(logWhen, logAction, st.fired, ACTION_PULSEOFF, 2021, 6, 1, 12, 0), 1);
+  ok &= Check("Weekday On at 7:30 on Monday 11/8", FiredOn(logWhen, logAction, st.fired, ACTION_ON, 2021, 11, 8, 7, 30), 1);
+
+  Simulate("America/New_York", 2021, &st, logWhen, logAction, 4096, true);
+  PrintStats("America/New_York 2021, NTP jumps", &st);
+  ok &= !st.mismatches;
+  Simulate("Europe/London", 2022, &st, NULL, NULL, 0, true);
+  PrintStats("Europe/London 2022, NTP jumps", &st);
+  ok &= !st.mismatches;
+  Simulate("Australia/Sydney", 2023, &st, NULL, NULL, 0, true);
+  PrintStats("Australia/Sydney 2023, NTP jumps", &st);
+  ok &= !st.mismatches;
+  return ok;
+}
+
+// Random rules, as many as given, so changes to the engine can be compared
+static bool CheckRandom(int count, const char *zone)
+{
+  ClearEvents();
+  srand(count);
+  for (int i=0; i<count; i++) {
+    AddEvent(1 + rand() % 127, rand() % 24, rand() % 60, 1 + rand() % ACTION_MAX);
+  }
+  SimStats st;
+  char what[64];
+  snprintf(what, sizeof(what), "%s, %d random rules", zone, count);
+  Simulate(zone, 2021, &st, NULL, NULL, 0, true);
+  PrintStats(what, &st);
+  return !st.mismatches;
+}
+
+int main(int argc, const char *argv[])
+{
+  tzQuiet = true;
+  if (argc > 1 && !strcmp(argv[1], "--bench")) {
+    int count = (argc > 2) ? atoi(argv[2]) : MAXEVENTS;
+    if (count < 0 || count > MAXEVENTS) count = MAXEVENTS;
+    return CheckRandom(count, (argc > 3) ? argv[3] : "America/New_York") ? 0 : 1;
+  }
+  bool ok = CheckRules();
+  ok &= CheckRandom(24, "America/Los_Angeles");
+  ok &= CheckRandom(MAXEVENTS, "Europe/Berlin");
+  printf("%s\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}
+#endif
@@ -21,10 +21,12 @@
 #ifndef _schedule_h
 #define _schedule_h
 
+#if !defined(TEST_SCHEDULE) && !defined(TEST_SETUP)
 #include <Arduino.h>
+#endif
 
-// Maximum # of events to operate upon
-#define MAXEVENTS (24) 
+// Maximum # of events to operate upon.  Only the ones in use take up RAM and flash
+#define MAXEVENTS (256)
 
 typedef struct {
   byte dayMask; // binary flags per-day
@@ -33,20 +35,32 @@ typedef struct {
   byte action;
 } Event;
 
+// The events in use, numbered 0..EventCount()-1 with no gaps
+int EventCount();
+const Event *GetEvent(int id); // NULL if out of range
+// Replace event id, append if id==EventCount(), or remove it (renumbering the rest) if the action is ACTION_NONE.
+// False if id is out of range or the list is full.  Call SaveSettings() afterwards to keep the change
+bool SetEvent(int id, const Event *e);
+void ClearEvents();
+
 #define ACTION_NONE     (0)
 #define ACTION_ON       (1)
 #define ACTION_OFF      (2)
 #define ACTION_TOGGLE   (3)
 #define ACTION_PULSEOFF (4)
 #define ACTION_PULSEON  (5)
-#define ACTION_MAX      (5)
+#define ACTION_ONFOR    (6)
+#define ACTION_MAX      (6)
 extern char *GetActionString(int idx, char *str, int len);
-extern void PerformAction(int action);
+// Timed actions (pulses, On For Time) take ms, or the length from the settings if 0
+extern void PerformAction(int action, unsigned long ms = 0);
 
 
 // Handle scheduled operations
 void ManageSchedule();
 void StopSchedule();
+time_t NextEventAt(time_t local, int *action); // Local time of the next event (and its action), 0 if none
+time_t NextScheduleUTC(); // ManageSchedule() has nothing to do before this UTC time, 0 if it hasn't worked it out
 
 #endif
 
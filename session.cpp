@@ -0,0 +1,118 @@
+/*
+  PsychoPlug
+  ESP8266 based remote outlet with standalone timer and MQTT integration
+  
+  Copyright (C) 2017  Earle F. Philhower, III
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <Arduino.h>
+#include <Hash.h>  //sha1 exported here
+#include "session.h"
+#include "log.h"
+
+typedef struct {
+  uint8_t token[SESSION_TOKENLEN];
+  unsigned long lastMS; // Last time used
+  bool live;
+} Session;
+
+static Session sessions[SESSION_SLOTS];
+static uint8_t sessionKey[32]; // Random per boot, so tokens die with a reset
+static bool sessionKeyed = false;
+static unsigned long sessionSerial = 0;
+static char tokenHex[SESSION_TOKENHEX + 1];
+
+
+// RFC 2104 HMAC using the SDK's SHA-1, key and message are both short
+static void HMACSHA1(const uint8_t *key, int keyLen, const uint8_t *msg, int msgLen, uint8_t *out)
+{
+  uint8_t buff[64 + 32];
+  uint8_t inner[20];
+
+  for (int i=0; i<64; i++) buff[i] = ((i < keyLen) ? key[i] : 0) ^ 0x36;
+  memcpy(buff + 64, msg, msgLen);
+  sha1(buff, 64 + msgLen, inner);
+  for (int i=0; i<64; i++) buff[i] = ((i < keyLen) ? key[i] : 0) ^ 0x5c;
+  memcpy(buff + 64, inner, sizeof(inner));
+  sha1(buff, 64 + sizeof(inner), out);
+  memset(buff, 0, sizeof(buff));
+}
+
+static bool Expired(Session *s)
+{
+  return !s->live || (millis() - s->lastMS > SESSION_IDLE_MS);
+}
+
+const char *SessionCreate()
+{
+  if (!sessionKeyed) {
+    for (unsigned int i=0; i<sizeof(sessionKey); i++) sessionKey[i] = RANDOM_REG32 & 0xff;
+    sessionKeyed = true;
+  }
+
+  // Take a dead slot, or the least recently used one
+  Session *s = &sessions[0];
+  for (int i=0; i<SESSION_SLOTS; i++) {
+    if (Expired(&sessions[i])) { s = &sessions[i]; break; }
+    if (sessions[i].lastMS - s->lastMS > 0x80000000UL) s = &sessions[i]; // Older, wrap safe
+  }
+
+  // Token is the HMAC of a unique serial, time and some fresh randomness
+  uint32_t msg[4] = { (uint32_t)++sessionSerial, (uint32_t)millis(), RANDOM_REG32, RANDOM_REG32 };
+  HMACSHA1(sessionKey, sizeof(sessionKey), (const uint8_t *)msg, sizeof(msg), s->token);
+  s->lastMS = millis();
+  s->live = true;
+
+  for (int i=0; i<SESSION_TOKENLEN; i++) sprintf_P(tokenHex + i*2, PSTR("%02x"), s->token[i]);
+  LogPrintf("Session %d created\n", s - sessions);
+  return tokenHex;
+}
+
+static int HexVal(char c)
+{
+  if (c>='0' && c<='9') return c - '0';
+  if (c>='a' && c<='f') return c - 'a' + 10;
+  if (c>='A' && c<='F') return c - 'A' + 10;
+  return -1;
+}
+
+bool SessionCheck(const char *hex)
+{
+  uint8_t token[SESSION_TOKENLEN];
+  for (int i=0; i<SESSION_TOKENLEN; i++) {
+    int a = HexVal(hex[i*2]);
+    int b = (a < 0) ? -1 : HexVal(hex[i*2+1]);
+    if (b < 0) return false; // Also catches a short string
+    token[i] = (a << 4) | b;
+  }
+  if (hex[SESSION_TOKENHEX]) return false;
+
+  // Look at every byte of every slot so timing doesn't leak how close a guess was
+  Session *match = NULL;
+  for (int i=0; i<SESSION_SLOTS; i++) {
+    uint8_t diff = 0;
+    for (int j=0; j<SESSION_TOKENLEN; j++) diff |= sessions[i].token[j] ^ token[j];
+    if (!diff && !Expired(&sessions[i])) match = &sessions[i];
+  }
+  if (!match) return false;
+  match->lastMS = millis();
+  return true;
+}
+
+void StopSessions()
+{
+  memset(sessions, 0, sizeof(sessions));
+}
@@ -0,0 +1,38 @@
+/*
+  PsychoPlug
+  ESP8266 based remote outlet with standalone timer and MQTT integration
+  
+  Copyright (C) 2017  Earle F. Philhower, III
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _session_h
+#define _session_h
+
+#include <Arduino.h>
+
+// Authenticated sessions.  After a good Basic login the client gets a token
+// (cookie "psid", or "Authorization: Bearer <token>" for scripts) which is
+// checked against a small RAM table instead of re-hashing the password.
+#define SESSION_SLOTS (8)
+#define SESSION_TOKENLEN (20) // HMAC-SHA1 output
+#define SESSION_TOKENHEX (SESSION_TOKENLEN * 2)
+#define SESSION_IDLE_MS (30L * 60L * 1000L) // Unused sessions expire after this
+
+const char *SessionCreate(); // Returns the new token as hex, valid until the next call
+bool SessionCheck(const char *tokenHex); // Constant-time check against all live sessions
+void StopSessions(); // Forget every session
+
+#endif
@@ -20,18 +20,39 @@
 
 #include <Arduino.h>
 #include <EEPROM.h>
+#include <stddef.h>
 #include "settings.h"
 #include "password.h"
 #include "log.h"
 
-static byte CalcSettingsChecksum();
+static byte CalcChecksum(const byte *p, unsigned int len);
+static bool LoadLegacySettings(byte version);
+static void LoadEvents();
+static void SaveEvents();
+
+// Events live after the settings, 3 bytes each and only as many as are in use:
+//   count lo, count hi, checksum, ~checksum, then per event
+//   dayMask | minute-of-day bit 0 << 7, minute-of-day bits 1-8, minute-of-day bits 9-10 | action << 2
+#define EVENTSTORE_BASE (1024)
+#define EVENTSTORE_HDR (4)
+#define EVENTSTORE_SIZE (EVENTSTORE_BASE + EVENTSTORE_HDR + MAXEVENTS * 3)
+static_assert(sizeof(Settings) + 2 <= EVENTSTORE_BASE, "Settings overlap the event store");
+
+// Up to version 3 a fixed event[24] followed uiSalt inside the settings, and version 3 added
+// pulseMS and onForMins after it.  Both are only read, to upgrade
+#define LEGACYEVENTS (24)
+#define LEGACYEVENTOFS (offsetof(Settings, uiSalt) + SALTLEN)
+#define LEGACYTIMEDOFS ((LEGACYEVENTOFS + LEGACYEVENTS * sizeof(Event) + 1) & ~1)
+#define SETTINGSV2SIZE ((LEGACYEVENTOFS + LEGACYEVENTS * sizeof(Event) + 3) & ~3)
+#define SETTINGSV3SIZE ((LEGACYTIMEDOFS + 2 * sizeof(uint16_t) + 3) & ~3)
 
 Settings settings;
+static uint32_t settingsGeneration = 0;
 
 
 void StartSettings()
 {
-  EEPROM.begin(sizeof(settings)+2);
+  EEPROM.begin(EVENTSTORE_SIZE);
 }
 
 void StopSettings()
@@ -55,10 +76,19 @@ bool LoadSettings(bool reset)
   byte chk = EEPROM.read(sizeof(settings));
   byte notChk = EEPROM.read(sizeof(settings)+1);
 
-  byte calcChk = CalcSettingsChecksum();
+  byte calcChk = CalcChecksum((byte *)&settings, sizeof(settings));
   byte notCalcChk = ~calcChk;
 
-  if ((chk != calcChk) || (notChk != notCalcChk) ||(settings.version != SETTINGSVERSION) || (reset)) {
+  bool good = (chk == calcChk) && (notChk == notCalcChk) && (settings.version == SETTINGSVERSION);
+  bool upgraded = false;
+  if (good) {
+    ClearEvents();
+    LoadEvents();
+  } else if (settings.version == 2 || settings.version == 3) {
+    good = upgraded = LoadLegacySettings(settings.version);
+  }
+
+  if (!good || (reset)) {
     LogPrintf("Setting checksum mismatch, generating default settings\n");
     memset(&settings, 0, sizeof(settings));
     settings.version = SETTINGSVERSION;
@@ -81,6 +111,9 @@ bool LoadSettings(bool reset)
     settings.onAfterPFail = false;
 //    settings.voltage = 120;
     settings.mqttEnable = false;
+    settings.pulseMS = 2000;
+    settings.onForMins = 60;
+    ClearEvents();
     ok = false;
     LogPrintf("Unable to restore settings from EEPROM\n");
   } else {
@@ -90,30 +123,118 @@ bool LoadSettings(bool reset)
 
   StopSettings();
 
+  // Write out the new layout now so the old one is only ever read once
+  if (upgraded && ok) SaveSettings();
+
   return ok;
 }
 
+// Pull the settings and events out of a version 2 or 3 image, false if it's damaged
+static bool LoadLegacySettings(byte version)
+{
+  byte old[SETTINGSV3SIZE + 2];
+  unsigned int len = (version == 2) ? SETTINGSV2SIZE : SETTINGSV3SIZE;
+  for (unsigned int i=0; i<len+2; i++) old[i] = EEPROM.read(i);
+  byte ck = CalcChecksum(old, len);
+  if (old[len] != ck || old[len+1] != (byte)~ck) return false;
+
+  LogPrintf("Upgrading version %d settings\n", version);
+  memset(&settings, 0, sizeof(settings));
+  memcpy(&settings, old, LEGACYEVENTOFS);
+  settings.version = SETTINGSVERSION;
+  if (version == 3) {
+    memcpy(&settings.pulseMS, old + LEGACYTIMEDOFS, sizeof(uint16_t));
+    memcpy(&settings.onForMins, old + LEGACYTIMEDOFS + sizeof(uint16_t), sizeof(uint16_t));
+  } else {
+    settings.pulseMS = 2000;
+    settings.onForMins = 60;
+  }
+
+  // Unused slots are dropped, so the remaining events are renumbered from 0
+  ClearEvents();
+  for (int i=0; i<LEGACYEVENTS; i++) {
+    Event e;
+    memcpy(&e, old + LEGACYEVENTOFS + i * sizeof(Event), sizeof(Event));
+    if (e.action > ACTION_MAX || e.hour > 23 || e.minute > 59) continue;
+    SetEvent(EventCount(), &e);
+  }
+  return true;
+}
+
+static void LoadEvents()
+{
+  int count = EEPROM.read(EVENTSTORE_BASE) | (EEPROM.read(EVENTSTORE_BASE+1) << 8);
+  if (count > MAXEVENTS) count = 0;
+  byte c = 0xef ^ EEPROM.read(EVENTSTORE_BASE) ^ EEPROM.read(EVENTSTORE_BASE+1);
+  for (int i=0; i<count*3; i++) c ^= EEPROM.read(EVENTSTORE_BASE + EVENTSTORE_HDR + i);
+  if ((EEPROM.read(EVENTSTORE_BASE+2) != c) || (EEPROM.read(EVENTSTORE_BASE+3) != (byte)~c)) {
+    LogPrintf("Event store checksum mismatch, no events loaded\n");
+    return;
+  }
+
+  int addr = EVENTSTORE_BASE + EVENTSTORE_HDR;
+  for (int i=0; i<count; i++, addr+=3) {
+    byte b0 = EEPROM.read(addr);
+    byte b1 = EEPROM.read(addr+1);
+    byte b2 = EEPROM.read(addr+2);
+    int mod = (b0 >> 7) | (b1 << 1) | ((b2 & 3) << 9);
+    Event e;
+    e.dayMask = b0 & 0x7f;
+    e.hour = mod / 60;
+    e.minute = mod % 60;
+    e.action = b2 >> 2;
+    if (mod >= 24 * 60 || e.action > ACTION_MAX) continue;
+    SetEvent(EventCount(), &e);
+  }
+  LogPrintf("Loaded %d events\n", EventCount());
+}
+
+static void SaveEvents()
+{
+  int count = EventCount();
+  EEPROM.write(EVENTSTORE_BASE, count & 0xff);
+  EEPROM.write(EVENTSTORE_BASE+1, count >> 8);
+  byte c = 0xef ^ (count & 0xff) ^ (count >> 8);
+  int addr = EVENTSTORE_BASE + EVENTSTORE_HDR;
+  for (int i=0; i<count; i++, addr+=3) {
+    const Event *e = GetEvent(i);
+    int mod = e->hour * 60 + e->minute;
+    byte b[3] = { (byte)((e->dayMask & 0x7f) | ((mod & 1) << 7)), (byte)(mod >> 1), (byte)(((mod >> 9) & 3) | (e->action << 2)) };
+    for (int j=0; j<3; j++) {
+      EEPROM.write(addr+j, b[j]);
+      c ^= b[j];
+    }
+  }
+  EEPROM.write(EVENTSTORE_BASE+2, c);
+  EEPROM.write(EVENTSTORE_BASE+3, ~c);
+}
+
 void SaveSettings()
 {
   LogPrintf("Saving Settings\n");
+  settingsGeneration++;
 
   StartSettings();
   
   byte *p = (byte *)&settings;
   for (unsigned int i=0; i<sizeof(settings); i++) EEPROM.write(i, *(p++));
-  byte ck = CalcSettingsChecksum();
+  byte ck = CalcChecksum((byte *)&settings, sizeof(settings));
   EEPROM.write(sizeof(settings), ck);
   EEPROM.write(sizeof(settings)+1, ~ck);
+  SaveEvents();
   EEPROM.commit();
 
   StopSettings();
 }
 
-static byte CalcSettingsChecksum()
+static byte CalcChecksum(const byte *p, unsigned int len)
 {
-  byte *p = (byte*)&settings;
   byte c = 0xef;
-  for (unsigned int j=0; j<sizeof(settings); j++) c ^= *(p++);
+  for (unsigned int j=0; j<len; j++) c ^= *(p++);
   return c;
 }
 
+uint32_t SettingsGeneration()
+{
+  return settingsGeneration;
+}
@@ -21,11 +21,13 @@
 #ifndef _settings_h
 #define _settings_h
 
+#ifndef TEST_SETUP
 #include <Arduino.h>
+#endif
 #include "password.h"
 #include "schedule.h"
 
-#define SETTINGSVERSION (2)
+#define SETTINGSVERSION (4)
 
 typedef struct {
   byte version;
@@ -61,8 +63,9 @@ typedef struct {
   char uiPassEnc[PASSENCLEN];
   char uiSalt[SALTLEN];
 
-  // Events to process
-  Event event[MAXEVENTS];
+  // Timed actions
+  uint16_t pulseMS; // Pulse On/Off length
+  uint16_t onForMins; // On For Time length, unless the request gives one
 } Settings;
 extern Settings settings;
 
@@ -70,6 +73,7 @@ void StartSettings();
 bool LoadSettings(bool reset);
 void SaveSettings();
 void StopSettings();
+uint32_t SettingsGeneration(); // Bumped on every save, for cache validation
 
 #endif
 
@@ -0,0 +1,238 @@
+/*
+  PsychoPlug
+  ESP8266 based remote outlet with standalone timer and MQTT integration
+  
+  Copyright (C) 2017  Earle F. Philhower, III
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Host test, feeds whole and cut-off forms through the streaming parser:
+//   g++ -DTEST_SETUP -DTEST_WEB -O2 -o setuptest setupform.cpp form.cpp && ./setuptest
+
+#ifndef TEST_SETUP
+#include <Arduino.h>
+#include "settings.h"
+#include "password.h"
+#include "session.h"
+#include "form.h"
+#include "log.h"
+#else
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+typedef uint8_t byte;
+#define PSTR(x) (x)
+#define strcmp_P strcmp
+#define LogPrintf(...) printf(__VA_ARGS__)
+static size_t strlcpy(char *dest, const char *src, size_t size)
+{
+  snprintf(dest, size, "%s", src);
+  return strlen(src);
+}
+#include "settings.h"
+#include "form.h"
+static void StopSessions();
+#endif
+#include "setupform.h"
+
+// Only allocated while a form is being submitted.  One that was abandoned part way is
+// kept for the next form, which starts it over from the live settings
+static Settings *setupStage = NULL;
+
+// Handle one field of the setup form, called with NULL before the first one
+void SetupField(char *namePtr, char *valPtr)
+{
+  if (!namePtr) {
+    if (!setupStage) setupStage = (Settings *)malloc(sizeof(Settings));
+    if (!setupStage) {
+      LogPrintf("SetupField: Unable to allocate %d bytes, form ignored\n", (int)sizeof(Settings));
+      return;
+    }
+    memcpy(setupStage, &settings, sizeof(Settings));
+    // Checkboxes don't actually return values if they're unchecked, so by default these get false
+    setupStage->useDHCP = false;
+    setupStage->onAfterPFail = false;
+    setupStage->mqttEnable = false;
+    setupStage->mqttSSL = false;
+    setupStage->use12hr = false;
+    setupStage->usedmy = false;
+    return;
+  }
+  if (!setupStage) return;
+  Settings *s = setupStage;
+
+  ParamText("ssid", s->ssid);
+  ParamText("pass", s->psk);
+  ParamText("hn", s->hostname);
+  ParamCheckbox("dh", s->useDHCP);
+  Param4Int("ip", s->ip);
+  Param4Int("nm", s->netmask);
+  Param4Int("gw", s->gateway);
+  Param4Int("dns", s->dns);
+  Param4Int("logsvr", s->logsvr);
+  
+  ParamText("ntp", s->ntp);
+  ParamText("tz", s->timezone);
+  ParamCheckbox("use12hr", s->use12hr);
+  ParamCheckbox("usedmy", s->usedmy);
+
+  ParamCheckbox("pf", s->onAfterPFail);
+  int v = -1;
+  ParamInt("pulse", v);
+  if (v >= 100 && v <= 60000) s->pulseMS = v;
+  v = -1;
+  ParamInt("onfor", v);
+  if (v >= 1 && v <= 24 * 60) s->onForMins = v;
+
+  ParamCheckbox("mEn", s->mqttEnable);
+  ParamText("mhost", s->mqttHost);
+  ParamInt("mport", s->mqttPort);
+//  int v;
+//  ParamInt("voltage", v);
+//  if ((v<80) || (v>255)) v=120; // Sanity-check
+//  s->voltage = v;
+  ParamCheckbox("mssl", s->mqttSSL);
+  ParamText("mtopic", s->mqttTopic);
+  ParamText("mclientid", s->mqttClientID);
+  ParamText("muser", s->mqttUser);
+  ParamText("mpass", s->mqttPass);
+
+  ParamText("uiuser", s->uiUser);
+  if (!strcmp(namePtr, "uipass") && strcmp_P(valPtr, PSTR("*****"))) {
+    // Was changed, regenerate salt and store it
+    HashPassword(valPtr, s->uiSalt, s->uiPassEnc);
+    memset(valPtr, 0, strlen(valPtr)); // I think I'm paranoid
+  }
+}
+
+void ParseSetupForm(char *params)
+{
+  char *valPtr;
+  char *namePtr;
+  
+  SetupField(NULL, NULL);
+  while (ParseParam(&params, &namePtr, &valPtr)) {
+    SetupField(namePtr, valPtr);
+  }
+}
+
+bool ApplySetupForm()
+{
+  if (!setupStage) return false;
+  // New credentials end every session handed out under the old ones
+  if (strcmp(setupStage->uiUser, settings.uiUser) || memcmp(setupStage->uiPassEnc, settings.uiPassEnc, PASSENCLEN)) {
+    StopSessions();
+  }
+  memcpy(&settings, setupStage, sizeof(Settings));
+  free(setupStage);
+  setupStage = NULL;
+  return true;
+}
+
+
+#ifdef TEST_SETUP
+Settings settings;
+static int sessionsStopped = 0;
+static int failures = 0;
+
+void HashPassword(const char *pass, char *uiSalt, char *uiPassEnc)
+{
+  memset(uiSalt, 's', SALTLEN);
+  snprintf(uiPassEnc, PASSENCLEN, "%s", pass);
+}
+
+static void StopSessions()
+{
+  sessionsStopped++;
+}
+
+static void Check(const char *what, bool ok)
+{
+  if (!ok) {
+    printf("FAIL %s\n", what);
+    failures++;
+  }
+}
+
+static void DefaultSettings()
+{
+  memset(&settings, 0, sizeof(settings));
+  strcpy(settings.ssid, "Home");
+  settings.useDHCP = true;
+  settings.mqttEnable = true;
+  settings.use12hr = true;
+  strcpy(settings.uiUser, "admin");
+  strcpy(settings.uiPassEnc, "old");
+  settings.pulseMS = 2000;
+  settings.onForMins = 60;
+}
+
+// Stream the first len bytes of a body in small pieces, like a slow client would send it
+static void Feed(const char *body, int len, bool complete)
+{
+  char field[64];
+  FormParser form;
+  FormBegin(&form, field, sizeof(field), SetupField);
+  for (int i=0; i<len; i+=7) FormFeed(&form, body + i, (len - i < 7) ? len - i : 7);
+  if (complete) FormEnd(&form);
+}
+
+int main()
+{
+  const char *body = "ssid=Other&pass=secret&hn=plug&ip=10.0.0.5&nm=255.255.255.0&gw=10.0.0.1&dns=10.0.0.1"
+                     "&ntp=pool.ntp.org&tz=Europe%2FLondon&pulse=500&onfor=5&mhost=broker&mport=1883"
+                     "&uiuser=admin&uipass=newpass";
+  Settings before;
+
+  // Cut off everywhere along the body, then the request fails and nothing is applied
+  for (int len=0; len<(int)strlen(body); len++) {
+    DefaultSettings();
+    memcpy(&before, &settings, sizeof(settings));
+    sessionsStopped = 0;
+    Feed(body, len, len % 2);
+    if (memcmp(&before, &settings, sizeof(settings)) || sessionsStopped) {
+      printf("FAIL settings changed by a body cut off at %d bytes\n", len);
+      failures++;
+      break;
+    }
+  }
+
+  // The whole body, then the request completes
+  DefaultSettings();
+  sessionsStopped = 0;
+  Feed(body, strlen(body), true);
+  Check("applied", ApplySetupForm());
+  Check("ssid", !strcmp(settings.ssid, "Other"));
+  Check("dhcp cleared", !settings.useDHCP);
+  Check("mqtt cleared", !settings.mqttEnable);
+  Check("ip", settings.ip[0] == 10 && settings.ip[3] == 5);
+  Check("timezone", !strcmp(settings.timezone, "Europe/London"));
+  Check("pulse", settings.pulseMS == 500 && settings.onForMins == 5);
+  Check("password", !strcmp(settings.uiPassEnc, "newpass"));
+  Check("sessions stopped", sessionsStopped == 1);
+  Check("nothing left to apply", !ApplySetupForm());
+
+  // Same credentials keep the sessions
+  sessionsStopped = 0;
+  char same[] = "ssid=Home&uiuser=admin&uipass=*****";
+  ParseSetupForm(same);
+  Check("applied again", ApplySetupForm());
+  Check("sessions kept", sessionsStopped == 0);
+
+  printf("%s\n", failures ? "FAIL" : "PASS");
+  return failures ? 1 : 0;
+}
+#endif
@@ -0,0 +1,31 @@
+/*
+  PsychoPlug
+  ESP8266 based remote outlet with standalone timer and MQTT integration
+  
+  Copyright (C) 2017  Earle F. Philhower, III
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _setupform_h
+#define _setupform_h
+
+// The setup form.  Fields are written to a staging copy of the settings, so a form that
+// never finishes arriving (timeout, disconnect, truncated body) leaves the live ones alone.
+// SetupField() is the streaming FormHandler, called with NULLs to start a new copy.
+void SetupField(char *namePtr, char *valPtr);
+void ParseSetupForm(char *params); // A whole, already buffered, form
+bool ApplySetupForm(); // Request complete, copy the form over the settings.  False if it couldn't be staged
+
+#endif
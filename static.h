@@ -0,0 +1,185 @@
+// Generated by make-static-h.pl from static/, do not edit
+
+static const uint8_t static_sched_js[] PROGMEM = {
+  0x2f,0x2f,0x20,0x46,0x69,0x6c,0x6c,0x20,0x69,0x6e,0x20,0x74,0x68,0x65,0x20,0x73,
+  0x74,0x61,0x74,0x75,0x73,0x20,0x70,0x61,0x67,0x65,0x27,0x73,0x20,0x73,0x63,0x68,
+  0x65,0x64,0x75,0x6c,0x65,0x20,0x74,0x61,0x62,0x6c,0x65,0x20,0x66,0x72,0x6f,0x6d,
+  0x20,0x74,0x68,0x65,0x20,0x4a,0x53,0x4f,0x4e,0x20,0x41,0x50,0x49,0x2e,0x20,0x20,
+  0x54,0x68,0x65,0x20,0x74,0x61,0x62,0x6c,0x65,0x27,0x73,0x0a,0x2f,0x2f,0x20,0x64,
+  0x61,0x74,0x61,0x2d,0x6d,0x61,0x78,0x20,0x61,0x6e,0x64,0x20,0x64,0x61,0x74,0x61,
+  0x2d,0x31,0x32,0x68,0x72,0x20,0x61,0x74,0x74,0x72,0x69,0x62,0x75,0x74,0x65,0x73,
+  0x20,0x67,0x69,0x76,0x65,0x20,0x74,0x68,0x65,0x20,0x6d,0x6f,0x73,0x74,0x20,0x72,
+  0x75,0x6c,0x65,0x73,0x20,0x61,0x6c,0x6c,0x6f,0x77,0x65,0x64,0x20,0x61,0x6e,0x64,
+  0x20,0x74,0x69,0x6d,0x65,0x20,0x66,0x6f,0x72,0x6d,0x61,0x74,0x0a,0x28,0x66,0x75,
+  0x6e,0x63,0x74,0x69,0x6f,0x6e,0x28,0x29,0x20,0x7b,0x0a,0x20,0x20,0x76,0x61,0x72,
+  0x20,0x74,0x62,0x6c,0x20,0x3d,0x20,0x64,0x6f,0x63,0x75,0x6d,0x65,0x6e,0x74,0x2e,
+  0x67,0x65,0x74,0x45,0x6c,0x65,0x6d,0x65,0x6e,0x74,0x42,0x79,0x49,0x64,0x28,0x27,
+  0x73,0x63,0x68,0x65,0x64,0x27,0x29,0x3b,0x0a,0x20,0x20,0x69,0x66,0x20,0x28,0x21,
+  0x74,0x62,0x6c,0x29,0x20,0x72,0x65,0x74,0x75,0x72,0x6e,0x3b,0x0a,0x20,0x20,0x76,
+  0x61,0x72,0x20,0x6d,0x61,0x78,0x20,0x3d,0x20,0x70,0x61,0x72,0x73,0x65,0x49,0x6e,
+  0x74,0x28,0x74,0x62,0x6c,0x2e,0x67,0x65,0x74,0x41,0x74,0x74,0x72,0x69,0x62,0x75,
+  0x74,0x65,0x28,0x27,0x64,0x61,0x74,0x61,0x2d,0x6d,0x61,0x78,0x27,0x29,0x29,0x3b,
+  0x0a,0x20,0x20,0x76,0x61,0x72,0x20,0x75,0x73,0x65,0x31,0x32,0x68,0x72,0x20,0x3d,
+  0x20,0x74,0x62,0x6c,0x2e,0x67,0x65,0x74,0x41,0x74,0x74,0x72,0x69,0x62,0x75,0x74,
+  0x65,0x28,0x27,0x64,0x61,0x74,0x61,0x2d,0x31,0x32,0x68,0x72,0x27,0x29,0x20,0x3d,
+  0x3d,0x3d,0x20,0x27,0x31,0x27,0x3b,0x0a,0x20,0x20,0x76,0x61,0x72,0x20,0x6e,0x61,
+  0x6d,0x65,0x73,0x20,0x3d,0x20,0x7b,0x20,0x6e,0x6f,0x6e,0x65,0x3a,0x20,0x27,0x4e,
+  0x6f,0x6e,0x65,0x27,0x2c,0x20,0x6f,0x6e,0x3a,0x20,0x27,0x4f,0x6e,0x27,0x2c,0x20,
+  0x6f,0x66,0x66,0x3a,0x20,0x27,0x4f,0x66,0x66,0x27,0x2c,0x20,0x74,0x6f,0x67,0x67,
+  0x6c,0x65,0x3a,0x20,0x27,0x54,0x6f,0x67,0x67,0x6c,0x65,0x27,0x2c,0x20,0x70,0x75,
+  0x6c,0x73,0x65,0x6f,0x66,0x66,0x3a,0x20,0x27,0x50,0x75,0x6c,0x73,0x65,0x20,0x4f,
+  0x66,0x66,0x27,0x2c,0x20,0x70,0x75,0x6c,0x73,0x65,0x6f,0x6e,0x3a,0x20,0x27,0x50,
+  0x75,0x6c,0x73,0x65,0x20,0x4f,0x6e,0x27,0x2c,0x20,0x6f,0x6e,0x66,0x6f,0x72,0x3a,
+  0x20,0x27,0x4f,0x6e,0x20,0x46,0x6f,0x72,0x20,0x54,0x69,0x6d,0x65,0x27,0x20,0x7d,
+  0x3b,0x0a,0x20,0x20,0x76,0x61,0x72,0x20,0x64,0x61,0x79,0x73,0x20,0x3d,0x20,0x5b,
+  0x27,0x53,0x75,0x6e,0x27,0x2c,0x20,0x27,0x4d,0x6f,0x6e,0x27,0x2c,0x20,0x27,0x54,
+  0x75,0x65,0x27,0x2c,0x20,0x27,0x57,0x65,0x64,0x27,0x2c,0x20,0x27,0x54,0x68,0x75,
+  0x27,0x2c,0x20,0x27,0x46,0x72,0x69,0x27,0x2c,0x20,0x27,0x53,0x61,0x74,0x27,0x5d,
+  0x3b,0x0a,0x0a,0x20,0x20,0x66,0x75,0x6e,0x63,0x74,0x69,0x6f,0x6e,0x20,0x63,0x65,
+  0x6c,0x6c,0x28,0x72,0x6f,0x77,0x2c,0x20,0x68,0x74,0x6d,0x6c,0x2c,0x20,0x74,0x68,
+  0x29,0x20,0x7b,0x0a,0x20,0x20,0x20,0x20,0x76,0x61,0x72,0x20,0x63,0x20,0x3d,0x20,
+  0x64,0x6f,0x63,0x75,0x6d,0x65,0x6e,0x74,0x2e,0x63,0x72,0x65,0x61,0x74,0x65,0x45,
+  0x6c,0x65,0x6d,0x65,0x6e,0x74,0x28,0x74,0x68,0x20,0x3f,0x20,0x27,0x74,0x68,0x27,
+  0x20,0x3a,0x20,0x27,0x74,0x64,0x27,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x63,0x2e,
+  0x69,0x6e,0x6e,0x65,0x72,0x48,0x54,0x4d,0x4c,0x20,0x3d,0x20,0x68,0x74,0x6d,0x6c,
+  0x3b,0x0a,0x20,0x20,0x20,0x20,0x72,0x6f,0x77,0x2e,0x61,0x70,0x70,0x65,0x6e,0x64,
+  0x43,0x68,0x69,0x6c,0x64,0x28,0x63,0x29,0x3b,0x0a,0x20,0x20,0x7d,0x0a,0x0a,0x20,
+  0x20,0x66,0x75,0x6e,0x63,0x74,0x69,0x6f,0x6e,0x20,0x74,0x69,0x6d,0x65,0x28,0x68,
+  0x72,0x2c,0x20,0x6d,0x6e,0x29,0x20,0x7b,0x0a,0x20,0x20,0x20,0x20,0x76,0x61,0x72,
+  0x20,0x6d,0x20,0x3d,0x20,0x28,0x6d,0x6e,0x20,0x3c,0x20,0x31,0x30,0x20,0x3f,0x20,
+  0x27,0x3a,0x30,0x27,0x20,0x3a,0x20,0x27,0x3a,0x27,0x29,0x20,0x2b,0x20,0x6d,0x6e,
+  0x3b,0x0a,0x20,0x20,0x20,0x20,0x69,0x66,0x20,0x28,0x21,0x75,0x73,0x65,0x31,0x32,
+  0x68,0x72,0x29,0x20,0x72,0x65,0x74,0x75,0x72,0x6e,0x20,0x68,0x72,0x20,0x2b,0x20,
+  0x6d,0x3b,0x0a,0x20,0x20,0x20,0x20,0x72,0x65,0x74,0x75,0x72,0x6e,0x20,0x28,0x28,
+  0x68,0x72,0x20,0x25,0x20,0x31,0x32,0x29,0x20,0x7c,0x7c,0x20,0x31,0x32,0x29,0x20,
+  0x2b,0x20,0x6d,0x20,0x2b,0x20,0x28,0x68,0x72,0x20,0x3c,0x20,0x31,0x32,0x20,0x3f,
+  0x20,0x27,0x20,0x41,0x4d,0x27,0x20,0x3a,0x20,0x27,0x20,0x50,0x4d,0x27,0x29,0x3b,
+  0x0a,0x20,0x20,0x7d,0x0a,0x0a,0x20,0x20,0x66,0x75,0x6e,0x63,0x74,0x69,0x6f,0x6e,
+  0x20,0x64,0x72,0x61,0x77,0x28,0x65,0x76,0x65,0x6e,0x74,0x73,0x29,0x20,0x7b,0x0a,
+  0x20,0x20,0x20,0x20,0x76,0x61,0x72,0x20,0x68,0x64,0x72,0x20,0x3d,0x20,0x74,0x62,
+  0x6c,0x2e,0x69,0x6e,0x73,0x65,0x72,0x74,0x52,0x6f,0x77,0x28,0x2d,0x31,0x29,0x3b,
+  0x0a,0x20,0x20,0x20,0x20,0x63,0x65,0x6c,0x6c,0x28,0x68,0x64,0x72,0x2c,0x20,0x27,
+  0x23,0x27,0x2c,0x20,0x74,0x72,0x75,0x65,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,
+  0x6f,0x72,0x20,0x28,0x76,0x61,0x72,0x20,0x6a,0x20,0x3d,0x20,0x30,0x3b,0x20,0x6a,
+  0x20,0x3c,0x20,0x37,0x3b,0x20,0x6a,0x2b,0x2b,0x29,0x20,0x63,0x65,0x6c,0x6c,0x28,
+  0x68,0x64,0x72,0x2c,0x20,0x64,0x61,0x79,0x73,0x5b,0x6a,0x5d,0x2c,0x20,0x74,0x72,
+  0x75,0x65,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x63,0x65,0x6c,0x6c,0x28,0x68,0x64,
+  0x72,0x2c,0x20,0x27,0x54,0x69,0x6d,0x65,0x27,0x2c,0x20,0x74,0x72,0x75,0x65,0x29,
+  0x3b,0x0a,0x20,0x20,0x20,0x20,0x63,0x65,0x6c,0x6c,0x28,0x68,0x64,0x72,0x2c,0x20,
+  0x27,0x41,0x63,0x74,0x69,0x6f,0x6e,0x27,0x2c,0x20,0x74,0x72,0x75,0x65,0x29,0x3b,
+  0x0a,0x20,0x20,0x20,0x20,0x63,0x65,0x6c,0x6c,0x28,0x68,0x64,0x72,0x2c,0x20,0x27,
+  0x45,0x44,0x49,0x54,0x27,0x2c,0x20,0x74,0x72,0x75,0x65,0x29,0x3b,0x0a,0x20,0x20,
+  0x20,0x20,0x66,0x6f,0x72,0x20,0x28,0x76,0x61,0x72,0x20,0x69,0x20,0x3d,0x20,0x30,
+  0x3b,0x20,0x69,0x20,0x3c,0x20,0x65,0x76,0x65,0x6e,0x74,0x73,0x2e,0x6c,0x65,0x6e,
+  0x67,0x74,0x68,0x3b,0x20,0x69,0x2b,0x2b,0x29,0x20,0x7b,0x0a,0x20,0x20,0x20,0x20,
+  0x20,0x20,0x76,0x61,0x72,0x20,0x65,0x20,0x3d,0x20,0x65,0x76,0x65,0x6e,0x74,0x73,
+  0x5b,0x69,0x5d,0x3b,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x76,0x61,0x72,0x20,0x72,
+  0x6f,0x77,0x20,0x3d,0x20,0x74,0x62,0x6c,0x2e,0x69,0x6e,0x73,0x65,0x72,0x74,0x52,
+  0x6f,0x77,0x28,0x2d,0x31,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x63,0x65,
+  0x6c,0x6c,0x28,0x72,0x6f,0x77,0x2c,0x20,0x28,0x65,0x5b,0x30,0x5d,0x20,0x2b,0x20,
+  0x31,0x29,0x20,0x2b,0x20,0x27,0x2e,0x27,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x20,
+  0x20,0x66,0x6f,0x72,0x20,0x28,0x76,0x61,0x72,0x20,0x6a,0x20,0x3d,0x20,0x30,0x3b,
+  0x20,0x6a,0x20,0x3c,0x20,0x37,0x3b,0x20,0x6a,0x2b,0x2b,0x29,0x20,0x63,0x65,0x6c,
+  0x6c,0x28,0x72,0x6f,0x77,0x2c,0x20,0x28,0x65,0x5b,0x31,0x5d,0x20,0x26,0x20,0x28,
+  0x31,0x20,0x3c,0x3c,0x20,0x6a,0x29,0x29,0x20,0x3f,0x20,0x27,0x5b,0x58,0x5d,0x27,
+  0x20,0x3a,0x20,0x27,0x5b,0x26,0x6e,0x62,0x73,0x70,0x3b,0x5d,0x27,0x29,0x3b,0x0a,
+  0x20,0x20,0x20,0x20,0x20,0x20,0x63,0x65,0x6c,0x6c,0x28,0x72,0x6f,0x77,0x2c,0x20,
+  0x74,0x69,0x6d,0x65,0x28,0x65,0x5b,0x32,0x5d,0x2c,0x20,0x65,0x5b,0x33,0x5d,0x29,
+  0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x63,0x65,0x6c,0x6c,0x28,0x72,0x6f,
+  0x77,0x2c,0x20,0x6e,0x61,0x6d,0x65,0x73,0x5b,0x65,0x5b,0x34,0x5d,0x5d,0x29,0x3b,
+  0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x63,0x65,0x6c,0x6c,0x28,0x72,0x6f,0x77,0x2c,
+  0x20,0x27,0x3c,0x61,0x20,0x68,0x72,0x65,0x66,0x3d,0x22,0x65,0x64,0x69,0x74,0x2e,
+  0x68,0x74,0x6d,0x6c,0x3f,0x69,0x64,0x3d,0x27,0x20,0x2b,0x20,0x65,0x5b,0x30,0x5d,
+  0x20,0x2b,0x20,0x27,0x22,0x3e,0x45,0x64,0x69,0x74,0x3c,0x2f,0x61,0x3e,0x27,0x29,
+  0x3b,0x0a,0x20,0x20,0x20,0x20,0x7d,0x0a,0x20,0x20,0x20,0x20,0x69,0x66,0x20,0x28,
+  0x65,0x76,0x65,0x6e,0x74,0x73,0x2e,0x6c,0x65,0x6e,0x67,0x74,0x68,0x20,0x3c,0x20,
+  0x6d,0x61,0x78,0x29,0x20,0x7b,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x76,0x61,0x72,
+  0x20,0x61,0x64,0x64,0x20,0x3d,0x20,0x74,0x62,0x6c,0x2e,0x69,0x6e,0x73,0x65,0x72,
+  0x74,0x52,0x6f,0x77,0x28,0x2d,0x31,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,
+  0x63,0x65,0x6c,0x6c,0x28,0x61,0x64,0x64,0x2c,0x20,0x27,0x27,0x29,0x3b,0x0a,0x20,
+  0x20,0x20,0x20,0x20,0x20,0x61,0x64,0x64,0x2e,0x63,0x65,0x6c,0x6c,0x73,0x5b,0x30,
+  0x5d,0x2e,0x63,0x6f,0x6c,0x53,0x70,0x61,0x6e,0x20,0x3d,0x20,0x31,0x30,0x3b,0x0a,
+  0x20,0x20,0x20,0x20,0x20,0x20,0x61,0x64,0x64,0x2e,0x63,0x65,0x6c,0x6c,0x73,0x5b,
+  0x30,0x5d,0x2e,0x69,0x6e,0x6e,0x65,0x72,0x48,0x54,0x4d,0x4c,0x20,0x3d,0x20,0x27,
+  0x3c,0x61,0x20,0x68,0x72,0x65,0x66,0x3d,0x22,0x65,0x64,0x69,0x74,0x2e,0x68,0x74,
+  0x6d,0x6c,0x3f,0x69,0x64,0x3d,0x27,0x20,0x2b,0x20,0x65,0x76,0x65,0x6e,0x74,0x73,
+  0x2e,0x6c,0x65,0x6e,0x67,0x74,0x68,0x20,0x2b,0x20,0x27,0x22,0x3e,0x41,0x64,0x64,
+  0x20,0x72,0x75,0x6c,0x65,0x3c,0x2f,0x61,0x3e,0x27,0x3b,0x0a,0x20,0x20,0x20,0x20,
+  0x7d,0x0a,0x20,0x20,0x7d,0x0a,0x0a,0x20,0x20,0x76,0x61,0x72,0x20,0x72,0x65,0x71,
+  0x20,0x3d,0x20,0x6e,0x65,0x77,0x20,0x58,0x4d,0x4c,0x48,0x74,0x74,0x70,0x52,0x65,
+  0x71,0x75,0x65,0x73,0x74,0x28,0x29,0x3b,0x0a,0x20,0x20,0x72,0x65,0x71,0x2e,0x6f,
+  0x6e,0x6c,0x6f,0x61,0x64,0x20,0x3d,0x20,0x66,0x75,0x6e,0x63,0x74,0x69,0x6f,0x6e,
+  0x28,0x29,0x20,0x7b,0x0a,0x20,0x20,0x20,0x20,0x69,0x66,0x20,0x28,0x72,0x65,0x71,
+  0x2e,0x73,0x74,0x61,0x74,0x75,0x73,0x20,0x3d,0x3d,0x3d,0x20,0x32,0x30,0x30,0x29,
+  0x20,0x64,0x72,0x61,0x77,0x28,0x4a,0x53,0x4f,0x4e,0x2e,0x70,0x61,0x72,0x73,0x65,
+  0x28,0x72,0x65,0x71,0x2e,0x72,0x65,0x73,0x70,0x6f,0x6e,0x73,0x65,0x54,0x65,0x78,
+  0x74,0x29,0x2e,0x65,0x76,0x65,0x6e,0x74,0x73,0x29,0x3b,0x0a,0x20,0x20,0x7d,0x3b,
+  0x0a,0x20,0x20,0x72,0x65,0x71,0x2e,0x6f,0x70,0x65,0x6e,0x28,0x27,0x47,0x45,0x54,
+  0x27,0x2c,0x20,0x27,0x61,0x70,0x69,0x2f,0x76,0x31,0x2f,0x73,0x63,0x68,0x65,0x64,
+  0x75,0x6c,0x65,0x27,0x29,0x3b,0x0a,0x20,0x20,0x72,0x65,0x71,0x2e,0x73,0x65,0x6e,
+  0x64,0x28,0x29,0x3b,0x0a,0x7d,0x29,0x28,0x29,0x3b,0x0a,
+};
+static const uint8_t static_sched_js_gz[] PROGMEM = {
+  0x1f,0x8b,0x08,0x00,0x00,0x00,0x00,0x00,0x00,0xff,0x85,0x55,0x51,0x6f,0xdb,0x36,
+  0x10,0x7e,0xcf,0xaf,0xb8,0x75,0x58,0x49,0x21,0xa9,0x6c,0xb9,0x05,0x06,0xc4,0x56,
+  0x0b,0x6f,0x4b,0xda,0x0c,0x75,0x1b,0x34,0x06,0x56,0x40,0xd0,0x03,0x63,0x9d,0x2d,
+  0x05,0x12,0xa5,0x92,0x54,0xdc,0xa2,0xcd,0x7f,0xdf,0x1d,0x25,0x25,0xf6,0x60,0xaf,
+  0x0f,0x36,0x29,0xde,0xc7,0xbb,0xef,0xee,0x3b,0x92,0xa3,0x11,0x5c,0x16,0x65,0x09,
+  0x85,0x06,0x97,0x23,0x58,0xa7,0x5c,0x6b,0xa1,0x51,0x1b,0x14,0x16,0xec,0x2a,0xc7,
+  0xac,0x2d,0x11,0x9c,0xba,0xa5,0xff,0xb5,0xa9,0x2b,0x8f,0xfa,0xfb,0xe6,0xe3,0x07,
+  0x98,0x5f,0x5f,0x85,0x00,0xcb,0xbc,0xb7,0x0a,0x7b,0x32,0x1a,0x41,0xa6,0x9c,0x7a,
+  0x51,0xa9,0xaf,0xa0,0x74,0xd6,0x7d,0x44,0x93,0xdc,0x80,0x72,0xce,0x14,0xb7,0xad,
+  0x43,0x0b,0x9b,0xe2,0x1e,0xbd,0x93,0xaa,0xb6,0x0e,0x0c,0x79,0xb7,0xa0,0xca,0xb2,
+  0xde,0x62,0xe6,0x37,0xb9,0xa2,0xa2,0x48,0xb5,0xa9,0x94,0x3b,0x91,0xeb,0x56,0xaf,
+  0x5c,0x51,0x6b,0x19,0xc0,0xf7,0x13,0x80,0x7b,0x65,0xc0,0xdd,0x96,0x10,0x43,0x56,
+  0xaf,0xda,0x0a,0xb5,0x0b,0x37,0xe8,0x2e,0x4a,0xe4,0xe9,0x1f,0xdf,0xae,0x32,0x29,
+  0x3c,0x65,0x11,0x4c,0x09,0x5d,0xac,0x41,0xfe,0x42,0xf0,0x00,0x0c,0xba,0xd6,0xe8,
+  0x69,0xef,0x81,0xe9,0xc5,0x94,0xa2,0xb1,0x78,0xa5,0x9d,0x24,0x04,0x7b,0x99,0x0f,
+  0x14,0xa5,0x18,0x92,0x10,0x41,0x30,0xec,0x69,0x2d,0xfa,0x44,0x62,0x38,0x02,0x67,
+  0xab,0x08,0x20,0x8e,0x63,0x10,0x91,0x18,0xb6,0x69,0x55,0x51,0x7a,0x31,0x7c,0x07,
+  0x5d,0x6b,0x3c,0x07,0xf1,0x81,0x06,0x71,0x06,0xb5,0xa6,0xf9,0x47,0xcd,0xb3,0xf5,
+  0x9a,0xa7,0xeb,0x35,0xcd,0x5d,0xbd,0xd9,0x94,0x8c,0x5a,0xfa,0x09,0xad,0x34,0x6d,
+  0x69,0xb1,0x83,0x5c,0xf3,0x14,0x3a,0x60,0xb7,0xac,0x9f,0x56,0xbd,0x27,0x4d,0x55,
+  0xf3,0x6e,0xe1,0xb2,0x36,0xb0,0xa4,0x3a,0x0a,0x78,0x18,0x98,0x64,0xea,0x1b,0x13,
+  0x49,0xc4,0x4d,0xcb,0x60,0xb1,0xa8,0xfd,0xb0,0x6c,0x39,0x8c,0xf8,0x87,0x6a,0xc6,
+  0x5f,0x79,0xcb,0xc3,0xa5,0x29,0x78,0xb8,0x51,0x4e,0xa4,0xd3,0x13,0x72,0x30,0xc8,
+  0x00,0x2b,0x2c,0x4b,0x69,0xea,0xed,0x19,0xe4,0xae,0x2a,0x89,0x71,0xde,0x09,0xd3,
+  0xc5,0x58,0xed,0x0a,0xb3,0x32,0xa8,0x1c,0xf6,0xda,0x48,0x97,0xc3,0x1b,0x10,0x2e,
+  0x17,0x40,0x0c,0x5d,0x2f,0x10,0xc0,0x2a,0x2c,0xb4,0x46,0xf3,0x6e,0xb9,0x78,0x4f,
+  0x7b,0xd9,0x67,0xb7,0x4e,0x21,0x42,0xd5,0x34,0xa8,0xb3,0x3f,0xf3,0xa2,0xcc,0xe4,
+  0xca,0xe3,0x1f,0xf6,0xb8,0x70,0xa3,0xc8,0xdc,0x9c,0x41,0xa5,0x77,0x49,0x54,0xe4,
+  0x48,0x56,0x1a,0x66,0x10,0x8d,0x39,0xe6,0xf9,0xd8,0xc7,0x3c,0x27,0x71,0x4e,0x09,
+  0xda,0xf9,0xf7,0xad,0xd1,0x6b,0x3a,0xb4,0x07,0x90,0xbc,0x84,0xe8,0x09,0x74,0x4b,
+  0x92,0x02,0xc0,0x6f,0x10,0x4d,0x02,0xf8,0xf1,0xc3,0x0f,0x84,0xa0,0x1f,0x2f,0x53,
+  0x80,0x09,0x07,0x80,0xf9,0xc2,0x47,0x80,0xeb,0x85,0x38,0x40,0x33,0x33,0x6a,0x2b,
+  0xf1,0x9e,0x8a,0x60,0x77,0x69,0xe6,0xd9,0xd0,0x4c,0x85,0xb6,0x68,0xdc,0xa7,0x7a,
+  0x2b,0x5f,0x44,0x43,0x59,0xb8,0xcc,0x84,0x20,0x11,0x7e,0xe5,0xbe,0x30,0x2d,0xf6,
+  0x16,0x92,0x18,0x24,0xef,0xbf,0xa3,0xdd,0xe3,0x29,0x0d,0x33,0xf8,0x9d,0x86,0xd3,
+  0xd3,0x60,0x67,0x17,0x8b,0x9d,0xdc,0xa5,0x7b,0x3b,0x77,0x7c,0xfa,0xd6,0x38,0x66,
+  0x9c,0x7b,0xda,0x47,0xcd,0x17,0x7f,0x5d,0x2d,0x8f,0x50,0x2a,0x3a,0x4a,0x05,0x51,
+  0xea,0xf2,0x0d,0x4b,0xd4,0x1b,0x97,0xd3,0x12,0xd3,0xeb,0x72,0xef,0xb2,0x47,0x82,
+  0x76,0x98,0xa4,0x48,0xa7,0x3b,0x06,0x12,0xfe,0x78,0x59,0x60,0xa7,0xff,0x24,0x26,
+  0xe3,0x94,0x94,0x88,0x58,0x12,0x11,0x8a,0x47,0xc8,0x4f,0x2b,0x34,0x6c,0x8f,0x52,
+  0x78,0x0e,0x32,0x82,0xd9,0x0c,0xee,0x82,0x80,0x95,0x4c,0x3e,0xa7,0x5e,0xc9,0xe4,
+  0xb9,0xbe,0xb5,0xcd,0x34,0x15,0x07,0xe2,0xfa,0xae,0xc3,0x64,0x42,0xc5,0xc5,0xe4,
+  0x65,0x1a,0x1c,0x80,0xf8,0x43,0x9f,0x60,0xf2,0x2a,0x4d,0x0f,0x58,0xc5,0x4c,0x51,
+  0xa7,0xe1,0x3a,0x7e,0x86,0x59,0xe1,0x42,0xee,0xf9,0x37,0x45,0x16,0x0b,0x4a,0xa3,
+  0x4f,0x49,0x3c,0x7b,0x7d,0x41,0xa6,0xd9,0x48,0xbd,0x1e,0x18,0x3c,0x3c,0x76,0xed,
+  0x5e,0x65,0x29,0x35,0xba,0xa6,0xf6,0x4b,0xab,0xb2,0xec,0xa7,0x15,0x24,0x0c,0x11,
+  0x79,0x4a,0x8f,0xbe,0x43,0x36,0x58,0x22,0x10,0xae,0xea,0xf2,0xa6,0x51,0x9a,0x9c,
+  0x44,0xe3,0x83,0x80,0xdd,0x23,0xfb,0x7f,0xd9,0xec,0x31,0xf5,0x69,0xcd,0x89,0x1b,
+  0xdf,0xf8,0x3e,0xb5,0xa7,0xcc,0xfc,0x81,0xf1,0xea,0xe3,0x17,0xf2,0xa9,0x71,0x0b,
+  0x9f,0x17,0xef,0xdf,0x39,0xd7,0x7c,0xc2,0x2f,0x2d,0x5a,0x27,0x3d,0x53,0xb2,0x86,
+  0xb5,0x2e,0x6b,0xc5,0x09,0xfe,0xe7,0x65,0xe8,0x8a,0xc3,0x88,0xfe,0x05,0xe3,0x8b,
+  0x78,0x32,0x1e,0x07,0xdd,0xf9,0xe3,0x07,0x2b,0xf4,0x37,0xbe,0xc7,0x18,0xb4,0x4d,
+  0x4d,0xd5,0x59,0xe2,0x57,0x17,0x84,0xfd,0xe1,0xf4,0x47,0xf7,0x31,0x0e,0xdd,0x3d,
+  0x52,0xbc,0xbd,0xe0,0x5e,0x17,0xaa,0x29,0x46,0xf7,0xd1,0x68,0x78,0x0d,0xc5,0x23,
+  0x1b,0x4b,0x17,0x14,0x73,0x7b,0x08,0xf8,0xff,0x5f,0xa2,0x23,0x5e,0x5d,0x4b,0x07,
+  0x00,0x00,
+};
+static const char static_sched_js_type[] PROGMEM = "application/javascript";
+static constexpr char static_sched_js_path[] PROGMEM = "sched.js";
+
+static const WebStatic webStatic[] PROGMEM = {
+  { WebHash(static_sched_js_path), static_sched_js_path, static_sched_js_type, static_sched_js, sizeof(static_sched_js), static_sched_js_gz, sizeof(static_sched_js_gz), 0xf6515106 },
+};
@@ -0,0 +1,53 @@
+// Fill in the status page's schedule table from the JSON API.  The table's
+// data-max and data-12hr attributes give the most rules allowed and time format
+(function() {
+  var tbl = document.getElementById('sched');
+  if (!tbl) return;
+  var max = parseInt(tbl.getAttribute('data-max'));
+  var use12hr = tbl.getAttribute('data-12hr') === '1';
+  var names = { none: 'None', on: 'On', off: 'Off', toggle: 'Toggle', pulseoff: 'Pulse Off', pulseon: 'Pulse On', onfor: 'On For Time' };
+  var days = ['Sun', 'Mon', 'Tue', 'Wed', 'Thu', 'Fri', 'Sat'];
+
+  function cell(row, html, th) {
+    var c = document.createElement(th ? 'th' : 'td');
+    c.innerHTML = html;
+    row.appendChild(c);
+  }
+
+  function time(hr, mn) {
+    var m = (mn < 10 ? ':0' : ':') + mn;
+    if (!use12hr) return hr + m;
+    return ((hr % 12) || 12) + m + (hr < 12 ? ' AM' : ' PM');
+  }
+
+  function draw(events) {
+    var hdr = tbl.insertRow(-1);
+    cell(hdr, '#', true);
+    for (var j = 0; j < 7; j++) cell(hdr, days[j], true);
+    cell(hdr, 'Time', true);
+    cell(hdr, 'Action', true);
+    cell(hdr, 'EDIT', true);
+    for (var i = 0; i < events.length; i++) {
+      var e = events[i];
+      var row = tbl.insertRow(-1);
+      cell(row, (e[0] + 1) + '.');
+      for (var j = 0; j < 7; j++) cell(row, (e[1] & (1 << j)) ? '[X]' : '[&nbsp;]');
+      cell(row, time(e[2], e[3]));
+      cell(row, names[e[4]]);
+      cell(row, '<a href="edit.html?id=' + e[0] + '">Edit</a>');
+    }
+    if (events.length < max) {
+      var add = tbl.insertRow(-1);
+      cell(add, '');
+      add.cells[0].colSpan = 10;
+      add.cells[0].innerHTML = '<a href="edit.html?id=' + events.length + '">Add rule</a>';
+    }
+  }
+
+  var req = new XMLHttpRequest();
+  req.onload = function() {
+    if (req.status === 200) draw(JSON.parse(req.responseText).events);
+  };
+  req.open('GET', 'api/v1/schedule');
+  req.send();
+})();
@@ -0,0 +1,142 @@
+/*
+  PsychoPlug
+  ESP8266 based remote outlet with standalone timer and MQTT integration
+  
+  Copyright (C) 2017  Earle F. Philhower, III
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <Arduino.h>
+#include "timer.h"
+
+typedef struct {
+  TimerCallback cb; // NULL when free
+  int arg;
+  unsigned long due; // Tick to fire on
+  uint16_t seq; // Bumped on every use so a stale handle can't cancel someone else's timer
+  int8_t next; // Next timer in the same wheel slot, -1 ends the list
+} Timer;
+
+static Timer timers[MAXTIMERS];
+static int8_t wheel[TIMER_SLOTS];
+static unsigned long curTick = 0; // Last tick processed
+static unsigned long curTickMS = 0; // millis() when it started, advanced a whole tick at a time so wraparound is harmless
+static bool timersInit = false;
+
+static void InitTimers()
+{
+  if (timersInit) return;
+  for (int i=0; i<TIMER_SLOTS; i++) wheel[i] = -1;
+  for (int i=0; i<MAXTIMERS; i++) timers[i].cb = NULL;
+  curTickMS = millis();
+  timersInit = true;
+}
+
+static void Unlink(int idx)
+{
+  int8_t *p = &wheel[timers[idx].due & (TIMER_SLOTS-1)];
+  while (*p != idx) p = &timers[*p].next;
+  *p = timers[idx].next;
+  timers[idx].cb = NULL;
+}
+
+int StartTimer(unsigned long ms, TimerCallback cb, int arg)
+{
+  InitTimers();
+  for (int i=0; i<MAXTIMERS; i++) {
+    if (timers[i].cb) continue;
+    // Counted from the tick we're in now, and always at least one tick out so a callback can re-arm itself
+    unsigned long ticks = (millis() - curTickMS + ms + TIMER_TICK_MS - 1) / TIMER_TICK_MS;
+    if (!ticks) ticks = 1;
+    timers[i].cb = cb;
+    timers[i].arg = arg;
+    timers[i].due = curTick + ticks;
+    if (!++timers[i].seq) timers[i].seq = 1;
+    int slot = timers[i].due & (TIMER_SLOTS-1);
+    timers[i].next = wheel[slot];
+    wheel[slot] = i;
+    return (timers[i].seq << 4) | i;
+  }
+  return 0;
+}
+
+static int TimerIndex(int handle)
+{
+  int idx = handle & 15;
+  if (!handle || idx >= MAXTIMERS || !timers[idx].cb || timers[idx].seq != (handle >> 4)) return -1;
+  return idx;
+}
+
+void CancelTimer(int *handle)
+{
+  int idx = TimerIndex(*handle);
+  if (idx >= 0) Unlink(idx);
+  *handle = 0;
+}
+
+static long MSLeft(int idx)
+{
+  long ms = (long)(timers[idx].due - curTick) * TIMER_TICK_MS - (long)(millis() - curTickMS);
+  return (ms < 0) ? 0 : ms;
+}
+
+long TimerMSLeft(int handle)
+{
+  int idx = TimerIndex(handle);
+  return (idx < 0) ? -1 : MSLeft(idx);
+}
+
+long NextTimerMS()
+{
+  long next = -1;
+  for (int i=0; i<MAXTIMERS; i++) {
+    if (!timers[i].cb) continue;
+    long ms = MSLeft(i);
+    if (next < 0 || ms < next) next = ms;
+  }
+  return next;
+}
+
+// Fire everything in this tick's slot that's due, the rest are on a later trip around the wheel
+static void RunSlot(unsigned long tick)
+{
+  int slot = tick & (TIMER_SLOTS-1);
+  int idx = wheel[slot];
+  while (idx >= 0) {
+    if ((long)(timers[idx].due - tick) > 0) {
+      idx = timers[idx].next;
+      continue;
+    }
+    TimerCallback cb = timers[idx].cb;
+    int arg = timers[idx].arg;
+    Unlink(idx);
+    cb(arg);
+    idx = wheel[slot]; // The callback may have started or cancelled timers, start over
+  }
+}
+
+void ManageTimers()
+{
+  InitTimers();
+  unsigned long ticks = (millis() - curTickMS) / TIMER_TICK_MS;
+  if (!ticks) return;
+  curTickMS += ticks * TIMER_TICK_MS;
+  // After a long stall one trip around the wheel catches everything up
+  if (ticks > TIMER_SLOTS) {
+    curTick += ticks - TIMER_SLOTS;
+    ticks = TIMER_SLOTS;
+  }
+  while (ticks--) RunSlot(++curTick);
+}
@@ -0,0 +1,47 @@
+/*
+  PsychoPlug
+  ESP8266 based remote outlet with standalone timer and MQTT integration
+  
+  Copyright (C) 2017  Earle F. Philhower, III
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _timer_h
+#define _timer_h
+
+#include <Arduino.h>
+
+// One-shot callbacks run from loop(), in place of delay()s in the middle of an action.
+// A hashed timer wheel: 100ms ticks, longer delays just go around the wheel more than once
+#define TIMER_TICK_MS (100)
+#define TIMER_SLOTS   (32)  // Power of 2
+#define MAXTIMERS     (8)
+
+typedef void (*TimerCallback)(int arg);
+
+// Returns a handle for CancelTimer(), or 0 if all timers are in use
+int StartTimer(unsigned long ms, TimerCallback cb, int arg);
+
+// Drops a pending timer (a stale or 0 handle is ignored) and zeroes the handle
+void CancelTimer(int *handle);
+long TimerMSLeft(int handle); // -1 if it isn't pending
+
+// ms until the next timer is due, or -1 if none are pending
+long NextTimerMS();
+
+// Runs everything that's come due
+void ManageTimers();
+
+#endif
@@ -38,21 +38,6 @@ typedef struct tm {
 } tm;
 */
 
-time_t mktime(struct tm *tm)
-{
-  tmElements_t tme;
-  tme.Second = tm->tm_sec;
-  tme.Minute = tm->tm_min; 
-  tme.Hour = tm->tm_hour; 
-  tme.Wday = tm->tm_wday+1;   // day of week, sunday is day 1
-  tme.Day = tm->tm_mday;
-  tme.Month = tm->tm_mon+1;  // Jan = 1 in tme, 0 in tm
-  tme.Year = (uint8_t)(tm->tm_year - 70); // offset from 1970; 
-  time_t t = makeTime(tme); // convert time elements into time_t
-  return t;
-  
-}
-
 struct tm *gmtime_r(const time_t *timep, struct tm *tm)
 {
   tmElements_t tme;
@@ -79,73 +64,134 @@ struct tm *gmtime_r(const time_t *timep, struct tm *tm)
 #include "tz.h"
 
 #define memcpy_P memcpy
+#define pgm_read_word(p) (*(p))
+#define PGM_P const char *
 #define snprintf_P snprintf
 #define strlcpy strncpy
 #define strncpy_P strncpy
-#define LogPrintf printf
+bool tzQuiet = false; // Benchmarks, checks and the schedule simulator call UpdateDSTInfo() a lot
+#define LogPrintf(...) { if (!tzQuiet) printf(__VA_ARGS__); }
 #define SECS_PER_MIN (60)
 #define SECS_PER_HOUR (60*60)
 #define SECS_PER_DAY (60*60*24)
 #endif
 
 
-char *GetNextTZ(bool reset, char *buff, char buffLen)
+// Every timezone name as a sorted, ready to send list of <option>s in flash
+PGM_P GetTZOptions(int *len)
 {
-	static uint16_t idxTZ = 0;
-	static uint16_t idxLink = 0;
-	if (reset) {
-		idxLink = 0;
-		idxTZ = 0;
-	}
+  *len = sizeof(tzOptions) - 1;
+  return tzOptions;
+}
 
-  const int tzcount = sizeof(mtimezone)/sizeof(mtimezone[0]);
-  const int linkcount = sizeof(link)/sizeof(link[0]);
-	if (idxTZ < tzcount) {
-    timezone_t l;
-    memcpy_P(&l, &mtimezone[idxTZ], sizeof(l));
-		strlcpy(buff + l.zoneNameFromPrev,l.zonename, buffLen - l.zoneNameFromPrev);
-		idxTZ++;
-		return buff;
-	} else if (idxLink < linkcount) {
-    link_t l;
-    memcpy_P(&l, &link[idxLink], sizeof(l));
-    strlcpy(buff + l.zoneNameFromPrev,  l.zonename, buffLen - l.zoneNameFromPrev);
-		idxLink++;
-		return buff;
-	} else {
-		return NULL;
-	}
+// Position of tzName in the sorted name list, by binary search.  -1 if not found
+static int FindTZIndex(const char *tzName)
+{
+  const int nameOff = 8; // "<option>"
+  int lo = 0;
+  int hi = sizeof(tzOptionOffset)/sizeof(tzOptionOffset[0]) - 1;
+  while (lo <= hi) {
+    int mid = (lo + hi) / 2;
+    int off = pgm_read_word(&tzOptionOffset[mid]) + nameOff;
+    char buff[64];
+    int len = sizeof(tzOptions) - 1 - off;
+    if (len > (int)sizeof(buff) - 1) len = sizeof(buff) - 1;
+    memcpy_P(buff, tzOptions + off, len);
+    buff[len] = 0;
+    char *end = strchr(buff, '<');
+    if (end) *end = 0;
+    int cmp = strcmp(tzName, buff);
+    if (!cmp) return mid;
+    if (cmp < 0) hi = mid - 1;
+    else lo = mid + 1;
+  }
+  return -1;
+}
+
+// Offset in GetTZOptions() just past tzName's "<option", where a " selected" can go.  -1 if not found
+int FindTZOption(const char *tzName)
+{
+  int idx = FindTZIndex(tzName);
+  if (idx < 0) return -1;
+  return pgm_read_word(&tzOptionOffset[idx]) + 7; // "<option"
 }
 
+// mtimezone[] entry for a zone or link name, -1 if not found
 int FindTZName(const char *tzname)
 {
-	char buff[64];
-  const int tzcount = sizeof(mtimezone)/sizeof(mtimezone[0]);
-  const int linkcount = sizeof(link)/sizeof(link[0]);
-	for (int i=0; i < tzcount; i++) {
-    timezone_t l;
-    memcpy_P(&l, &mtimezone[i], sizeof(l));
-		strlcpy(buff + l.zoneNameFromPrev,  l.zonename, sizeof(buff) - l.zoneNameFromPrev);
-		if (!strcmp(buff, tzname)) return i;
-	}
-	for (int i=0; i < linkcount; i++) {
-    link_t l;
-    memcpy_P(&l, &link[i], sizeof(l));
-		strlcpy(buff + l.zoneNameFromPrev,  l.zonename, sizeof(buff) - l.zoneNameFromPrev);
-		if (!strcmp(buff, tzname)) return link[i].timezone;
-	}
-	return -1;
+  int idx = FindTZIndex(tzname);
+  if (idx < 0) return -1;
+  return pgm_read_word(&tzOptionZone[idx]);
 }
 
 static timezone_t myTimezone;    // Which timezone are we in?
 static time_t utcOffsetSecs = 0; // Unadjusted UTC offset
 static bool useDSTRule = false;  // Does the current TZ need DST handling?
 static uint16_t dstYear = 1900;  // What year the cached computations below are falid for
+static time_t dstYearStartUTC = 0; // UTC bounds of dstYear, so LocalTime() needn't break down every time
+static time_t dstYearEndUTC = 0;
 static time_t dstChangeAtUTC[2]; // UTC time when the offset below takes effect
 static time_t dstOffsetSecs[2];  // Delta from default UTC offset to apply
 static char timezoneStr[16];     // Human readable string w/format specifiers for DST/non-DST
 static char dstString[2][4];     // Format specifier replacement
 
+// Days from 1/1/1970 to the given date (month 0-11, day 1-31), proleptic Gregorian.
+// Counts years from March so the leap day falls at the end, then it's just arithmetic.
+static long DaysFromCivil(int year, int month, int day)
+{
+  year += month / 12;
+  month = month % 12;
+  if (month < 2) year--;
+  long era = ((year >= 0) ? year : year - 399) / 400;
+  long yoe = year - era * 400;                                   // 0...399
+  long doy = (153 * ((month < 2) ? month + 10 : month - 2) + 2) / 5 + day - 1; // 0...365
+  long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;              // 0...146096
+  return era * 146097 + doe - 719468;
+}
+
+// 0=Sunday, 1/1/1970 was a Thursday
+static int DayOfWeek(long days)
+{
+  return (int)(((days % 7) + 11) % 7);
+}
+
+// Weekday a rule's trigger looks for, and whether it's the last one in the month.  -1 for a given day
+static int TriggerWeekday(int daytrig, bool *last)
+{
+  *last = false;
+  switch (daytrig) {
+    case SUN_LAST: *last = true; // Fall through
+    case SUN_GTEQ: return 0;
+    case MON_LAST: *last = true; // Fall through
+    case MON_GTEQ: return 1;
+    case TUE_LAST: *last = true; // Fall through
+    case TUE_GTEQ: return 2;
+    case WED_LAST: *last = true; // Fall through
+    case WED_GTEQ: return 3;
+    case THU_LAST: *last = true; // Fall through
+    case THU_GTEQ: return 4;
+    case FRI_LAST: *last = true; // Fall through
+    case FRI_GTEQ: return 5;
+    case SAT_LAST: *last = true; // Fall through
+    case SAT_GTEQ: return 6;
+  }
+  return -1;
+}
+
+// Day (since 1/1/1970) a rule fires on in the given year
+static long RuleDay(const rule_t *rule, int year)
+{
+  bool last;
+  int wday = TriggerWeekday(rule->daytrig, &last);
+  if (wday < 0) return DaysFromCivil(year, rule->month, rule->daynum);
+  if (last) {
+    long day = DaysFromCivil(year, rule->month + 1, 1) - 1; // Last of the month
+    return day - (DayOfWeek(day) - wday + 7) % 7;
+  }
+  long day = DaysFromCivil(year, rule->month, rule->daynum);
+  return day + (wday - DayOfWeek(day) + 7) % 7;
+}
+
 void UpdateDSTInfo(time_t whenUTC)
 {
   const int ruleCount = sizeof(rules)/sizeof(rules[0]);
@@ -170,101 +216,27 @@ void UpdateDSTInfo(time_t whenUTC)
 		return;
 	}
 
-  strlcpy(dstString[0], dstRule[0].fmtstr, sizeof(dstString[0]));
-  strlcpy(dstString[1], dstRule[1].fmtstr, sizeof(dstString[1]));
-
   gmtime_r(&whenUTC, &t);
   
 	int curYear = 1900 + t.tm_year;
 	dstYear = curYear;
+  dstYearStartUTC = (time_t)DaysFromCivil(curYear, 0, 1) * SECS_PER_DAY;
+  dstYearEndUTC = (time_t)DaysFromCivil(curYear + 1, 0, 1) * SECS_PER_DAY;
   LogPrintf(" UpdateDSTInfo year=%d\n", dstYear);
   
 	// Calculate the time when each rule will fire this year
 	for (int i=0; i<2; i++) {
-		memset(&t, sizeof(t), 0);
-		t.tm_year = curYear - 1900;
-		t.tm_mon = dstRule[i].month;
-		t.tm_mday = 1;
-		t.tm_isdst = 0;
-		t.tm_hour = 0;
-		t.tm_min = 0;
-		t.tm_sec = 0;
-		time_t at = mktime(&t);
-    LogPrintf(" UpdateDSTInfo: t.tm_year = %d, at = %ld\n", (int)t.tm_year, (long)at);
-		// Fill in the wday, yday field
-    gmtime_r(&at, &t);
-		// Now we have "t" which has the UTC time for day 1 of the month.
-		// Adjust to the proper day mechanically.  Could be optimized
-		switch (dstRule[i].daytrig) {
-			case SUN_GTEQ:
-			case SUN_LAST:
-				while (0!=t.tm_wday) {t.tm_wday = (t.tm_wday+1)%7; t.tm_mday++; at += SECS_PER_DAY; }
-				break;
-			case MON_GTEQ:
-			case MON_LAST:
-				while (1!=t.tm_wday) {t.tm_wday = (t.tm_wday+1)%7; t.tm_mday++; at += SECS_PER_DAY; }
-				break;
-			case TUE_GTEQ:
-			case TUE_LAST:
-				while (2!=t.tm_wday) {t.tm_wday = (t.tm_wday+1)%7; t.tm_mday++; at += SECS_PER_DAY; }
-				break;
-			case WED_GTEQ:
-			case WED_LAST:
-				while (3!=t.tm_wday) {t.tm_wday = (t.tm_wday+1)%7; t.tm_mday++; at += SECS_PER_DAY; }
-				break;
-			case THU_GTEQ:
-			case THU_LAST:
-				while (4!=t.tm_wday) {t.tm_wday = (t.tm_wday+1)%7; t.tm_mday++; at += SECS_PER_DAY; }
-				break;
-			case FRI_GTEQ:
-			case FRI_LAST:
-				while (5!=t.tm_wday) {t.tm_wday = (t.tm_wday+1)%7; t.tm_mday++; at += SECS_PER_DAY; }
-				break;
-			case SAT_GTEQ:
-			case SAT_LAST:
-				while (6!=t.tm_wday) {t.tm_wday = (t.tm_wday+1)%7; t.tm_mday++; at += SECS_PER_DAY; }
-				break;
+		time_t at = (time_t)RuleDay(&dstRule[i], curYear) * SECS_PER_DAY;
 
-			case GIVEN_DAY:  // Simplest, update day and recalc AT
-				t.tm_mday = dstRule[i].daynum;
-				at = mktime(&t);
-				break;
-		}
-		switch (dstRule[i].daytrig) {
-			case SUN_GTEQ:
-			case MON_GTEQ:
-			case TUE_GTEQ:
-			case WED_GTEQ:
-			case THU_GTEQ:
-			case FRI_GTEQ:
-			case SAT_GTEQ:
-				while (t.tm_mday < dstRule[i].daynum) { t.tm_mday += 7; at += SECS_PER_DAY * 7; }
-				break;
-			case SUN_LAST:
-			case MON_LAST:
-			case TUE_LAST:
-			case WED_LAST:
-			case THU_LAST:
-			case FRI_LAST:
-			case SAT_LAST:
-				// Go to the next month and work backwards
-				while (t.tm_mon == dstRule[i].month) {
-					at += 7 * SECS_PER_DAY;
-          gmtime_r(&at, &t);
-				}
-				at -= 7 * SECS_PER_DAY; // Back one week
-        gmtime_r(&at, &t);
-				break;
-		}
-		// Now at == t == day of the event
+		// Now at == day of the event
 		int secToFire = abs(dstRule[i].athr) * SECS_PER_HOUR + dstRule[i].atmin * SECS_PER_MIN;
 		if (dstRule[i].athr<0) secToFire = -secToFire;
 		at += secToFire; 
 		
 		// Now see where this time is relative to and adjust appropriately.
-		int dstoffsecs = abs(dstRule[i].offsethrs) * 3600 + dstRule[i].offsetmins;
+		int dstoffsecs = abs(dstRule[i].offsethrs) * SECS_PER_HOUR + dstRule[i].offsetmins * SECS_PER_MIN;
 		if (dstRule[i].offsethrs<0) dstoffsecs = -dstoffsecs;
-		int otherdstoffsecs = abs(dstRule[i?0:1].offsethrs) * 3600 + dstRule[i?0:1].offsetmins;
+		int otherdstoffsecs = abs(dstRule[i?0:1].offsethrs) * SECS_PER_HOUR + dstRule[i?0:1].offsetmins * SECS_PER_MIN;
 		if (dstRule[i?0:1].offsethrs<0) otherdstoffsecs = -otherdstoffsecs;
 		switch(dstRule[i].atref) {
 			case ATREF_U:
@@ -280,12 +252,25 @@ void UpdateDSTInfo(time_t whenUTC)
 				at -= otherdstoffsecs;
 				break;
 		}
-    gmtime_r(&at, &t);
 		dstChangeAtUTC[i] = at;
 		dstOffsetSecs[i] = dstoffsecs;
+    strlcpy(dstString[i], dstRule[i].fmtstr, sizeof(dstString[i]));
+	}
+
+  // Rules are sorted by name, not date.  Southern zones (and Ramadan breaks) need them swapped
+  // so that between the two changes is always the 1st rule's offset
+  if (dstChangeAtUTC[0] > dstChangeAtUTC[1]) {
+    time_t at = dstChangeAtUTC[0]; dstChangeAtUTC[0] = dstChangeAtUTC[1]; dstChangeAtUTC[1] = at;
+    time_t ofs = dstOffsetSecs[0]; dstOffsetSecs[0] = dstOffsetSecs[1]; dstOffsetSecs[1] = ofs;
+    char str[sizeof(dstString[0])];
+    memcpy(str, dstString[0], sizeof(str));
+    memcpy(dstString[0], dstString[1], sizeof(str));
+    memcpy(dstString[1], str, sizeof(str));
+  }
+  for (int i=0; i<2; i++) {
     LogPrintf(" UpdateDSTInfo: dstChangeAtUTC[%d] = %ld\n", i, (long)dstChangeAtUTC[i]);
     LogPrintf(" UpdateDSTInfo: dstOffsetSecs[%d] = %ld\n", i, (long)dstOffsetSecs[i]);
-	}
+  }
   LogPrintf("-UpdateDSTInfo()\n");
 }
 
@@ -305,13 +290,15 @@ bool SetTZ(const char *tzName)
   memcpy_P(&myTimezone, &mtimezone[timezoneNum], sizeof(myTimezone));
 
 	// Store the UTC offset in seconds
-	utcOffsetSecs = abs(myTimezone.gmtoffhr) * 3600 + myTimezone.gmtoffmin;
+	utcOffsetSecs = abs(myTimezone.gmtoffhr) * SECS_PER_HOUR + myTimezone.gmtoffmin * SECS_PER_MIN;
 	if (myTimezone.gmtoffhr < 0) utcOffsetSecs = -utcOffsetSecs;
 
   // Store the timezone human readable string
   strlcpy(timezoneStr, myTimezone.formatstr, sizeof(timezoneStr));
 
   dstYear = 0; // Force it to fix on the 1st call
+  dstYearStartUTC = 0;
+  dstYearEndUTC = 0;
 	if (myTimezone.rule == RULE_NONE) {
 		useDSTRule = false;
 	} else {
@@ -323,10 +310,8 @@ bool SetTZ(const char *tzName)
 
 time_t LocalTime(time_t whenUTC)
 {
-  struct tm t;
-  gmtime_r(&whenUTC, &t);
-  
-  if ((dstYear != t.tm_year + 1900) && useDSTRule) UpdateDSTInfo(whenUTC);
+  // Only a new year (or timezone) needs the changes worked out again
+  if (useDSTRule && ((whenUTC < dstYearStartUTC) || (whenUTC >= dstYearEndUTC))) UpdateDSTInfo(whenUTC);
   if (!useDSTRule) {
     // Just UTC offset needed 
     return whenUTC + utcOffsetSecs;
@@ -339,6 +324,16 @@ time_t LocalTime(time_t whenUTC)
   }
 }
 
+// The next DST change, or the start of next year when the changes are worked out again.  0 if the zone has none
+time_t NextOffsetChange(time_t whenUTC)
+{
+  LocalTime(whenUTC); // Make sure this year's changes are current
+  if (!useDSTRule) return 0;
+  if (whenUTC < dstChangeAtUTC[0]) return dstChangeAtUTC[0];
+  if (whenUTC < dstChangeAtUTC[1]) return dstChangeAtUTC[1];
+  return dstYearEndUTC;
+}
+
 static char *Weekday(int wd, char *dest, int len)
 {
   switch (wd) {
@@ -403,11 +398,220 @@ char *AscTime(time_t whenUTC, bool use12Hr, bool useDMY, char *buff, int buffLen
 }
 
 
-#ifdef TEST_TIMEZONE
+#if defined(TEST_TIMEZONE) && !defined(TEST_SCHEDULE) // Which has its own main() and doesn't use these checks
+// The original linear search through the compressed tables, as the reference
+static int FindTZNameLinear(const char *tzname)
+{
+	char buff[64];
+	const int tzcount = sizeof(mtimezone)/sizeof(mtimezone[0]);
+	const int linkcount = sizeof(link)/sizeof(link[0]);
+	for (int i=0; i < tzcount; i++) {
+		strlcpy(buff + mtimezone[i].zoneNameFromPrev, mtimezone[i].zonename, sizeof(buff) - mtimezone[i].zoneNameFromPrev);
+		if (!strcmp(buff, tzname)) return i;
+	}
+	for (int i=0; i < linkcount; i++) {
+		strlcpy(buff + link[i].zoneNameFromPrev, link[i].zonename, sizeof(buff) - link[i].zoneNameFromPrev);
+		if (!strcmp(buff, tzname)) return link[i].timezone;
+	}
+	return -1;
+}
+
+// Every zone and link name has to be found by the index, and agree with the tables
+static int CheckTZName(const char *name, int expect)
+{
+	int found = FindTZName(name);
+	if (found == expect) return 0;
+	printf("Mismatch for '%s': %d, expected %d\n", name, found, expect);
+	return 1;
+}
+
+static bool CheckTZNames()
+{
+	char buff[64];
+	int names = 0;
+	int bad = 0;
+	const int tzcount = sizeof(mtimezone)/sizeof(mtimezone[0]);
+	const int linkcount = sizeof(link)/sizeof(link[0]);
+	for (int i=0; i < tzcount; i++, names++) {
+		strlcpy(buff + mtimezone[i].zoneNameFromPrev, mtimezone[i].zonename, sizeof(buff) - mtimezone[i].zoneNameFromPrev);
+		bad += CheckTZName(buff, FindTZNameLinear(buff));
+	}
+	for (int i=0; i < linkcount; i++, names++) {
+		strlcpy(buff + link[i].zoneNameFromPrev, link[i].zonename, sizeof(buff) - link[i].zoneNameFromPrev);
+		bad += CheckTZName(buff, FindTZNameLinear(buff));
+	}
+	const char *missing[] = { "", "Nowhere/Land", "America", "America/New_Yor", "America/New_Yorkk", "Zulu2", "0" };
+	for (unsigned int i=0; i<sizeof(missing)/sizeof(missing[0]); i++, names++) {
+		bad += CheckTZName(missing[i], -1);
+	}
+	printf("%d names checked, %d bad\n", names, bad);
+	return !bad;
+}
+
+// The original day-by-day, week-by-week search for the day a rule fires, as the reference
+static long RuleDayStepping(const rule_t *rule, int year)
+{
+	struct tm t;
+	memset(&t, 0, sizeof(t));
+	t.tm_year = year - 1900;
+	t.tm_mon = rule->month;
+	t.tm_mday = 1;
+	time_t at = timegm(&t);
+	gmtime_r(&at, &t);
+	bool last;
+	int wday = TriggerWeekday(rule->daytrig, &last);
+	if (wday < 0) {
+		t.tm_mday = rule->daynum;
+		at = timegm(&t);
+	} else {
+		while (wday != t.tm_wday) { t.tm_wday = (t.tm_wday+1)%7; t.tm_mday++; at += SECS_PER_DAY; }
+		if (!last) {
+			while (t.tm_mday < rule->daynum) { t.tm_mday += 7; at += SECS_PER_DAY * 7; }
+		} else {
+			while (t.tm_mon == rule->month) {
+				at += 7 * SECS_PER_DAY;
+				gmtime_r(&at, &t);
+			}
+			at -= 7 * SECS_PER_DAY; // Back one week
+		}
+	}
+	return (long)(at / SECS_PER_DAY);
+}
+
+static double NowNS()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Closed form rule days against the stepping search, then every zone's offsets against glibc
+static bool CheckDST(int fromYear, int toYear)
+{
+	const int ruleCount = sizeof(rules)/sizeof(rules[0]);
+	const int tzcount = sizeof(mtimezone)/sizeof(mtimezone[0]);
+	int bad = 0;
+	long sum = 0;
+	tzQuiet = true;
+
+	for (int i=0; i<ruleCount; i++) {
+		for (int y=fromYear; y<=toYear; y++) {
+			if (RuleDay(&rules[i], y) != RuleDayStepping(&rules[i], y)) {
+				printf("Rule %d, %d: closed form day %ld, stepping %ld\n", i, y, RuleDay(&rules[i], y), RuleDayStepping(&rules[i], y));
+				bad++;
+			}
+		}
+	}
+	printf("%d rules x %d years: %d differ from the stepping search\n", ruleCount, toYear - fromYear + 1, bad);
+
+	const int reps = 20;
+	double start = NowNS();
+	for (int r=0; r<reps; r++) for (int i=0; i<ruleCount; i++) for (int y=fromYear; y<=toYear; y++) sum += RuleDay(&rules[i], y);
+	double closedNS = (NowNS() - start) / (reps * ruleCount * (toYear - fromYear + 1));
+	start = NowNS();
+	for (int r=0; r<reps; r++) for (int i=0; i<ruleCount; i++) for (int y=fromYear; y<=toYear; y++) sum += RuleDayStepping(&rules[i], y);
+	double stepNS = (NowNS() - start) / (reps * ruleCount * (toYear - fromYear + 1));
+	printf("Rule day: %.1f ns/call closed form, %.1f ns/call stepping (%ld)\n", closedNS, stepNS, sum & 1);
+
+	// Each zone, a sample every day plus both sides of each change, against the system's zoneinfo
+	char buff[64];
+	char path[128];
+	int zones = 0, clean = 0, currentBad = 0;
+	long calls = 0;
+	double updateNS = 0;
+	for (int z=0; z<tzcount; z++) {
+		strlcpy(buff + mtimezone[z].zoneNameFromPrev, mtimezone[z].zonename, sizeof(buff) - mtimezone[z].zoneNameFromPrev);
+		snprintf(path, sizeof(path), "/usr/share/zoneinfo/%s", buff);
+		FILE *f = fopen(path, "r");
+		if (!f) continue;
+		fclose(f);
+		setenv("TZ", buff, 1);
+		tzset();
+		SetTZ(buff);
+		zones++;
+		int badYears = 0, firstBad = 0, lastBad = 0;
+		for (int y=fromYear; y<=toYear; y++) {
+			time_t jan1 = (time_t)DaysFromCivil(y, 0, 1) * SECS_PER_DAY;
+			start = NowNS();
+			UpdateDSTInfo(jan1);
+			updateNS += NowNS() - start;
+			calls++;
+			bool yearBad = false;
+			for (int d=0; d<366+4 && !yearBad; d++) {
+				time_t t;
+				if (d < 366) t = jan1 + d * SECS_PER_DAY + 12 * SECS_PER_HOUR;
+				else if (useDSTRule) t = dstChangeAtUTC[(d - 366) / 2] - ((d & 1) ? 0 : 1);
+				else break;
+				struct tm lt;
+				localtime_r(&t, &lt);
+				if (LocalTime(t) - t != lt.tm_gmtoff) yearBad = true;
+			}
+			if (yearBad) {
+				if (!badYears) firstBad = y;
+				lastBad = y;
+				badYears++;
+			}
+		}
+		if (!badYears) clean++;
+		if (lastBad == toYear) {
+			// Differs under the current rules, not just history tz.h doesn't keep
+			printf("%s: differs in %d of %d years, %d...%d\n", buff, badYears, toYear - fromYear + 1, firstBad, lastBad);
+			currentBad++;
+		}
+	}
+	setenv("TZ", "", 1);
+	tzset();
+	tzQuiet = false;
+	printf("%d zones checked against zoneinfo for %d...%d: %d always agree, %d only differ historically, %d differ in %d\n",
+	       zones, fromYear, toYear, clean, zones - clean - currentBad, currentBad, toYear);
+	printf("UpdateDSTInfo: %.1f ns/call\n", updateNS / calls);
+	return !bad;
+}
+
+// LocalTime() as it was, breaking down the time on every call to check the year
+static time_t LocalTimeBreakdown(time_t whenUTC)
+{
+  struct tm t;
+  gmtime_r(&whenUTC, &t);
+  
+  if ((dstYear != t.tm_year + 1900) && useDSTRule) UpdateDSTInfo(whenUTC);
+  if (!useDSTRule) {
+    return whenUTC + utcOffsetSecs;
+  } else if ((whenUTC >= dstChangeAtUTC[0]) && (whenUTC < dstChangeAtUTC[1])) {
+    return whenUTC + utcOffsetSecs + dstOffsetSecs[0];
+  } else {
+    return whenUTC + utcOffsetSecs + dstOffsetSecs[1];
+  }
+}
+
+// A loop()'s worth of calls at a time, a second apart, over a couple of years
+static bool BenchLocalTime(const char *tzName)
+{
+	const long calls = 2L * 365 * 24 * 60 * 60;
+	time_t start = (time_t)DaysFromCivil(2020, 6, 1) * SECS_PER_DAY;
+	tzQuiet = true;
+	SetTZ(tzName);
+	time_t sum = 0;
+	double ns = NowNS();
+	for (long i=0; i<calls; i++) sum += LocalTimeBreakdown(start + i);
+	double breakdownNS = (NowNS() - ns) / calls;
+	SetTZ(tzName);
+	ns = NowNS();
+	for (long i=0; i<calls; i++) sum -= LocalTime(start + i);
+	double cachedNS = (NowNS() - ns) / calls;
+	tzQuiet = false;
+	printf("LocalTime(%s): %.1f ns/call with the cached year, %.1f ns/call breaking down each time\n", tzName, cachedNS, breakdownNS);
+	if (sum) printf("Results differ!\n");
+	return !sum;
+}
+
 int main(int argc, const char *argv[])
 {
 	setenv("TZ", "", 1);
-	if (argc<2) { printf("Please enter a timezone parameter\n"); exit(1); }
+	if (argc<2) { printf("Please enter a timezone parameter, --check-names, or --check-dst [from] [to], or --bench [timezone]\n"); exit(1); }
+	if (!strcmp(argv[1], "--check-names")) return CheckTZNames() ? 0 : 1;
+	if (!strcmp(argv[1], "--bench")) return BenchLocalTime((argc>2) ? argv[2] : "America/New_York") ? 0 : 1;
+	if (!strcmp(argv[1], "--check-dst")) return CheckDST((argc>2) ? atoi(argv[2]) : 1970, (argc>3) ? atoi(argv[3]) : 2100) ? 0 : 1;
 	SetTZ(argv[1]);
 
 	time_t now;
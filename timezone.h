@@ -23,8 +23,10 @@
 
 #include <TimeLib.h>
 
-extern char *GetNextTZ(bool reset, char *buff, char buffLen);
+extern PGM_P GetTZOptions(int *len);
+extern int FindTZOption(const char *tzName);
 extern time_t LocalTime(time_t whenUTC);
+extern time_t NextOffsetChange(time_t whenUTC); // Next UTC time LocalTime()'s offset could change, 0 if never
 extern bool SetTZ(const char *tzName);
 extern char *AscTime(time_t whenUTC, bool use12hr, bool usrDMY, char *buff, int buffLen);
 #endif
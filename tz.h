@@ -754,3 +754,682 @@ static const link_t link[] ICACHE_RODATA_ATTR = {
 { 0, "W-SU", 314 /*Europe/Moscow*/ },
 { 0, "Zulu", 288 /*Etc/UTC*/ },
 };
+
+// Sorted <option> list of all names, for the web UI
+static const char tzOptions[] ICACHE_RODATA_ATTR =
+"<option>Africa/Abidjan</option>"
+"<option>Africa/Accra</option>"
+"<option>Africa/Addis_Ababa</option>"
+"<option>Africa/Algiers</option>"
+"<option>Africa/Asmara</option>"
+"<option>Africa/Asmera</option>"
+"<option>Africa/Bamako</option>"
+"<option>Africa/Bangui</option>"
+"<option>Africa/Banjul</option>"
+"<option>Africa/Bissau</option>"
+"<option>Africa/Blantyre</option>"
+"<option>Africa/Brazzaville</option>"
+"<option>Africa/Bujumbura</option>"
+"<option>Africa/Cairo</option>"
+"<option>Africa/Casablanca</option>"
+"<option>Africa/Ceuta</option>"
+"<option>Africa/Conakry</option>"
+"<option>Africa/Dakar</option>"
+"<option>Africa/Dar_es_Salaam</option>"
+"<option>Africa/Djibouti</option>"
+"<option>Africa/Douala</option>"
+"<option>Africa/El_Aaiun</option>"
+"<option>Africa/Freetown</option>"
+"<option>Africa/Gaborone</option>"
+"<option>Africa/Harare</option>"
+"<option>Africa/Johannesburg</option>"
+"<option>Africa/Juba</option>"
+"<option>Africa/Kampala</option>"
+"<option>Africa/Khartoum</option>"
+"<option>Africa/Kigali</option>"
+"<option>Africa/Kinshasa</option>"
+"<option>Africa/Lagos</option>"
+"<option>Africa/Libreville</option>"
+"<option>Africa/Lome</option>"
+"<option>Africa/Luanda</option>"
+"<option>Africa/Lubumbashi</option>"
+"<option>Africa/Lusaka</option>"
+"<option>Africa/Malabo</option>"
+"<option>Africa/Maputo</option>"
+"<option>Africa/Maseru</option>"
+"<option>Africa/Mbabane</option>"
+"<option>Africa/Mogadishu</option>"
+"<option>Africa/Monrovia</option>"
+"<option>Africa/Nairobi</option>"
+"<option>Africa/Ndjamena</option>"
+"<option>Africa/Niamey</option>"
+"<option>Africa/Nouakchott</option>"
+"<option>Africa/Ouagadougou</option>"
+"<option>Africa/Porto-Novo</option>"
+"<option>Africa/Sao_Tome</option>"
+"<option>Africa/Timbuktu</option>"
+"<option>Africa/Tripoli</option>"
+"<option>Africa/Tunis</option>"
+"<option>Africa/Windhoek</option>"
+"<option>America/Adak</option>"
+"<option>America/Anchorage</option>"
+"<option>America/Anguilla</option>"
+"<option>America/Antigua</option>"
+"<option>America/Araguaina</option>"
+"<option>America/Argentina/Buenos_Aires</option>"
+"<option>America/Argentina/Catamarca</option>"
+"<option>America/Argentina/ComodRivadavia</option>"
+"<option>America/Argentina/Cordoba</option>"
+"<option>America/Argentina/Jujuy</option>"
+"<option>America/Argentina/La_Rioja</option>"
+"<option>America/Argentina/Mendoza</option>"
+"<option>America/Argentina/Rio_Gallegos</option>"
+"<option>America/Argentina/Salta</option>"
+"<option>America/Argentina/San_Juan</option>"
+"<option>America/Argentina/San_Luis</option>"
+"<option>America/Argentina/Tucuman</option>"
+"<option>America/Argentina/Ushuaia</option>"
+"<option>America/Aruba</option>"
+"<option>America/Asuncion</option>"
+"<option>America/Atikokan</option>"
+"<option>America/Atka</option>"
+"<option>America/Bahia</option>"
+"<option>America/Bahia_Banderas</option>"
+"<option>America/Barbados</option>"
+"<option>America/Belem</option>"
+"<option>America/Belize</option>"
+"<option>America/Blanc-Sablon</option>"
+"<option>America/Boa_Vista</option>"
+"<option>America/Bogota</option>"
+"<option>America/Boise</option>"
+"<option>America/Buenos_Aires</option>"
+"<option>America/Cambridge_Bay</option>"
+"<option>America/Campo_Grande</option>"
+"<option>America/Cancun</option>"
+"<option>America/Caracas</option>"
+"<option>America/Catamarca</option>"
+"<option>America/Cayenne</option>"
+"<option>America/Cayman</option>"
+"<option>America/Chicago</option>"
+"<option>America/Chihuahua</option>"
+"<option>America/Coral_Harbour</option>"
+"<option>America/Cordoba</option>"
+"<option>America/Costa_Rica</option>"
+"<option>America/Creston</option>"
+"<option>America/Cuiaba</option>"
+"<option>America/Curacao</option>"
+"<option>America/Danmarkshavn</option>"
+"<option>America/Dawson</option>"
+"<option>America/Dawson_Creek</option>"
+"<option>America/Denver</option>"
+"<option>America/Detroit</option>"
+"<option>America/Dominica</option>"
+"<option>America/Edmonton</option>"
+"<option>America/Eirunepe</option>"
+"<option>America/El_Salvador</option>"
+"<option>America/Ensenada</option>"
+"<option>America/Fort_Nelson</option>"
+"<option>America/Fort_Wayne</option>"
+"<option>America/Fortaleza</option>"
+"<option>America/Glace_Bay</option>"
+"<option>America/Godthab</option>"
+"<option>America/Goose_Bay</option>"
+"<option>America/Grand_Turk</option>"
+"<option>America/Grenada</option>"
+"<option>America/Guadeloupe</option>"
+"<option>America/Guatemala</option>"
+"<option>America/Guayaquil</option>"
+"<option>America/Guyana</option>"
+"<option>America/Halifax</option>"
+"<option>America/Havana</option>"
+"<option>America/Hermosillo</option>"
+"<option>America/Indiana/Indianapolis</option>"
+"<option>America/Indiana/Knox</option>"
+"<option>America/Indiana/Marengo</option>"
+"<option>America/Indiana/Petersburg</option>"
+"<option>America/Indiana/Tell_City</option>"
+"<option>America/Indiana/Vevay</option>"
+"<option>America/Indiana/Vincennes</option>"
+"<option>America/Indiana/Winamac</option>"
+"<option>America/Indianapolis</option>"
+"<option>America/Inuvik</option>"
+"<option>America/Iqaluit</option>"
+"<option>America/Jamaica</option>"
+"<option>America/Jujuy</option>"
+"<option>America/Juneau</option>"
+"<option>America/Kentucky/Louisville</option>"
+"<option>America/Kentucky/Monticello</option>"
+"<option>America/Knox_IN</option>"
+"<option>America/Kralendijk</option>"
+"<option>America/La_Paz</option>"
+"<option>America/Lima</option>"
+"<option>America/Los_Angeles</option>"
+"<option>America/Louisville</option>"
+"<option>America/Lower_Princes</option>"
+"<option>America/Maceio</option>"
+"<option>America/Managua</option>"
+"<option>America/Manaus</option>"
+"<option>America/Marigot</option>"
+"<option>America/Martinique</option>"
+"<option>America/Matamoros</option>"
+"<option>America/Mazatlan</option>"
+"<option>America/Mendoza</option>"
+"<option>America/Menominee</option>"
+"<option>America/Merida</option>"
+"<option>America/Metlakatla</option>"
+"<option>America/Mexico_City</option>"
+"<option>America/Miquelon</option>"
+"<option>America/Moncton</option>"
+"<option>America/Monterrey</option>"
+"<option>America/Montevideo</option>"
+"<option>America/Montreal</option>"
+"<option>America/Montserrat</option>"
+"<option>America/Nassau</option>"
+"<option>America/New_York</option>"
+"<option>America/Nipigon</option>"
+"<option>America/Nome</option>"
+"<option>America/Noronha</option>"
+"<option>America/North_Dakota/Beulah</option>"
+"<option>America/North_Dakota/Center</option>"
+"<option>America/North_Dakota/New_Salem</option>"
+"<option>America/Ojinaga</option>"
+"<option>America/Panama</option>"
+"<option>America/Pangnirtung</option>"
+"<option>America/Paramaribo</option>"
+"<option>America/Phoenix</option>"
+"<option>America/Port-au-Prince</option>"
+"<option>America/Port_of_Spain</option>"
+"<option>America/Porto_Acre</option>"
+"<option>America/Porto_Velho</option>"
+"<option>America/Puerto_Rico</option>"
+"<option>America/Punta_Arenas</option>"
+"<option>America/Rainy_River</option>"
+"<option>America/Rankin_Inlet</option>"
+"<option>America/Recife</option>"
+"<option>America/Regina</option>"
+"<option>America/Resolute</option>"
+"<option>America/Rio_Branco</option>"
+"<option>America/Rosario</option>"
+"<option>America/Santa_Isabel</option>"
+"<option>America/Santarem</option>"
+"<option>America/Santiago</option>"
+"<option>America/Santo_Domingo</option>"
+"<option>America/Sao_Paulo</option>"
+"<option>America/Scoresbysund</option>"
+"<option>America/Shiprock</option>"
+"<option>America/Sitka</option>"
+"<option>America/St_Barthelemy</option>"
+"<option>America/St_Johns</option>"
+"<option>America/St_Kitts</option>"
+"<option>America/St_Lucia</option>"
+"<option>America/St_Thomas</option>"
+"<option>America/St_Vincent</option>"
+"<option>America/Swift_Current</option>"
+"<option>America/Tegucigalpa</option>"
+"<option>America/Thule</option>"
+"<option>America/Thunder_Bay</option>"
+"<option>America/Tijuana</option>"
+"<option>America/Toronto</option>"
+"<option>America/Tortola</option>"
+"<option>America/Vancouver</option>"
+"<option>America/Virgin</option>"
+"<option>America/Whitehorse</option>"
+"<option>America/Winnipeg</option>"
+"<option>America/Yakutat</option>"
+"<option>America/Yellowknife</option>"
+"<option>Antarctica/Casey</option>"
+"<option>Antarctica/Davis</option>"
+"<option>Antarctica/DumontDUrville</option>"
+"<option>Antarctica/Macquarie</option>"
+"<option>Antarctica/Mawson</option>"
+"<option>Antarctica/McMurdo</option>"
+"<option>Antarctica/Palmer</option>"
+"<option>Antarctica/Rothera</option>"
+"<option>Antarctica/South_Pole</option>"
+"<option>Antarctica/Syowa</option>"
+"<option>Antarctica/Troll</option>"
+"<option>Antarctica/Vostok</option>"
+"<option>Arctic/Longyearbyen</option>"
+"<option>Asia/Aden</option>"
+"<option>Asia/Almaty</option>"
+"<option>Asia/Amman</option>"
+"<option>Asia/Anadyr</option>"
+"<option>Asia/Aqtau</option>"
+"<option>Asia/Aqtobe</option>"
+"<option>Asia/Ashgabat</option>"
+"<option>Asia/Ashkhabad</option>"
+"<option>Asia/Atyrau</option>"
+"<option>Asia/Baghdad</option>"
+"<option>Asia/Bahrain</option>"
+"<option>Asia/Baku</option>"
+"<option>Asia/Bangkok</option>"
+"<option>Asia/Barnaul</option>"
+"<option>Asia/Beirut</option>"
+"<option>Asia/Bishkek</option>"
+"<option>Asia/Brunei</option>"
+"<option>Asia/Calcutta</option>"
+"<option>Asia/Chita</option>"
+"<option>Asia/Choibalsan</option>"
+"<option>Asia/Chongqing</option>"
+"<option>Asia/Chungking</option>"
+"<option>Asia/Colombo</option>"
+"<option>Asia/Dacca</option>"
+"<option>Asia/Damascus</option>"
+"<option>Asia/Dhaka</option>"
+"<option>Asia/Dili</option>"
+"<option>Asia/Dubai</option>"
+"<option>Asia/Dushanbe</option>"
+"<option>Asia/Famagusta</option>"
+"<option>Asia/Gaza</option>"
+"<option>Asia/Harbin</option>"
+"<option>Asia/Hebron</option>"
+"<option>Asia/Ho_Chi_Minh</option>"
+"<option>Asia/Hong_Kong</option>"
+"<option>Asia/Hovd</option>"
+"<option>Asia/Irkutsk</option>"
+"<option>Asia/Istanbul</option>"
+"<option>Asia/Jakarta</option>"
+"<option>Asia/Jayapura</option>"
+"<option>Asia/Jerusalem</option>"
+"<option>Asia/Kabul</option>"
+"<option>Asia/Kamchatka</option>"
+"<option>Asia/Karachi</option>"
+"<option>Asia/Kashgar</option>"
+"<option>Asia/Kathmandu</option>"
+"<option>Asia/Katmandu</option>"
+"<option>Asia/Khandyga</option>"
+"<option>Asia/Kolkata</option>"
+"<option>Asia/Krasnoyarsk</option>"
+"<option>Asia/Kuala_Lumpur</option>"
+"<option>Asia/Kuching</option>"
+"<option>Asia/Kuwait</option>"
+"<option>Asia/Macao</option>"
+"<option>Asia/Macau</option>"
+"<option>Asia/Magadan</option>"
+"<option>Asia/Makassar</option>"
+"<option>Asia/Manila</option>"
+"<option>Asia/Muscat</option>"
+"<option>Asia/Nicosia</option>"
+"<option>Asia/Novokuznetsk</option>"
+"<option>Asia/Novosibirsk</option>"
+"<option>Asia/Omsk</option>"
+"<option>Asia/Oral</option>"
+"<option>Asia/Phnom_Penh</option>"
+"<option>Asia/Pontianak</option>"
+"<option>Asia/Pyongyang</option>"
+"<option>Asia/Qatar</option>"
+"<option>Asia/Qyzylorda</option>"
+"<option>Asia/Rangoon</option>"
+"<option>Asia/Riyadh</option>"
+"<option>Asia/Saigon</option>"
+"<option>Asia/Sakhalin</option>"
+"<option>Asia/Samarkand</option>"
+"<option>Asia/Seoul</option>"
+"<option>Asia/Shanghai</option>"
+"<option>Asia/Singapore</option>"
+"<option>Asia/Srednekolymsk</option>"
+"<option>Asia/Taipei</option>"
+"<option>Asia/Tashkent</option>"
+"<option>Asia/Tbilisi</option>"
+"<option>Asia/Tehran</option>"
+"<option>Asia/Tel_Aviv</option>"
+"<option>Asia/Thimbu</option>"
+"<option>Asia/Thimphu</option>"
+"<option>Asia/Tokyo</option>"
+"<option>Asia/Tomsk</option>"
+"<option>Asia/Ujung_Pandang</option>"
+"<option>Asia/Ulaanbaatar</option>"
+"<option>Asia/Ulan_Bator</option>"
+"<option>Asia/Urumqi</option>"
+"<option>Asia/Ust-Nera</option>"
+"<option>Asia/Vientiane</option>"
+"<option>Asia/Vladivostok</option>"
+"<option>Asia/Yakutsk</option>"
+"<option>Asia/Yangon</option>"
+"<option>Asia/Yekaterinburg</option>"
+"<option>Asia/Yerevan</option>"
+"<option>Atlantic/Azores</option>"
+"<option>Atlantic/Bermuda</option>"
+"<option>Atlantic/Canary</option>"
+"<option>Atlantic/Cape_Verde</option>"
+"<option>Atlantic/Faeroe</option>"
+"<option>Atlantic/Faroe</option>"
+"<option>Atlantic/Jan_Mayen</option>"
+"<option>Atlantic/Madeira</option>"
+"<option>Atlantic/Reykjavik</option>"
+"<option>Atlantic/South_Georgia</option>"
+"<option>Atlantic/St_Helena</option>"
+"<option>Atlantic/Stanley</option>"
+"<option>Australia/ACT</option>"
+"<option>Australia/Adelaide</option>"
+"<option>Australia/Brisbane</option>"
+"<option>Australia/Broken_Hill</option>"
+"<option>Australia/Canberra</option>"
+"<option>Australia/Currie</option>"
+"<option>Australia/Darwin</option>"
+"<option>Australia/Eucla</option>"
+"<option>Australia/Hobart</option>"
+"<option>Australia/LHI</option>"
+"<option>Australia/Lindeman</option>"
+"<option>Australia/Lord_Howe</option>"
+"<option>Australia/Melbourne</option>"
+"<option>Australia/NSW</option>"
+"<option>Australia/North</option>"
+"<option>Australia/Perth</option>"
+"<option>Australia/Queensland</option>"
+"<option>Australia/South</option>"
+"<option>Australia/Sydney</option>"
+"<option>Australia/Tasmania</option>"
+"<option>Australia/Victoria</option>"
+"<option>Australia/West</option>"
+"<option>Australia/Yancowinna</option>"
+"<option>Brazil/Acre</option>"
+"<option>Brazil/DeNoronha</option>"
+"<option>Brazil/East</option>"
+"<option>Brazil/West</option>"
+"<option>CET</option>"
+"<option>CST6CDT</option>"
+"<option>Canada/Atlantic</option>"
+"<option>Canada/Central</option>"
+"<option>Canada/East-Saskatchewan</option>"
+"<option>Canada/Eastern</option>"
+"<option>Canada/Mountain</option>"
+"<option>Canada/Newfoundland</option>"
+"<option>Canada/Pacific</option>"
+"<option>Canada/Saskatchewan</option>"
+"<option>Canada/Yukon</option>"
+"<option>Chile/Continental</option>"
+"<option>Chile/EasterIsland</option>"
+"<option>Cuba</option>"
+"<option>EET</option>"
+"<option>EST</option>"
+"<option>EST5EDT</option>"
+"<option>Egypt</option>"
+"<option>Eire</option>"
+"<option>Etc/GMT</option>"
+"<option>Etc/GMT+0</option>"
+"<option>Etc/GMT+1</option>"
+"<option>Etc/GMT+10</option>"
+"<option>Etc/GMT+11</option>"
+"<option>Etc/GMT+12</option>"
+"<option>Etc/GMT+2</option>"
+"<option>Etc/GMT+3</option>"
+"<option>Etc/GMT+4</option>"
+"<option>Etc/GMT+5</option>"
+"<option>Etc/GMT+6</option>"
+"<option>Etc/GMT+7</option>"
+"<option>Etc/GMT+8</option>"
+"<option>Etc/GMT+9</option>"
+"<option>Etc/GMT-0</option>"
+"<option>Etc/GMT-1</option>"
+"<option>Etc/GMT-10</option>"
+"<option>Etc/GMT-11</option>"
+"<option>Etc/GMT-12</option>"
+"<option>Etc/GMT-13</option>"
+"<option>Etc/GMT-14</option>"
+"<option>Etc/GMT-2</option>"
+"<option>Etc/GMT-3</option>"
+"<option>Etc/GMT-4</option>"
+"<option>Etc/GMT-5</option>"
+"<option>Etc/GMT-6</option>"
+"<option>Etc/GMT-7</option>"
+"<option>Etc/GMT-8</option>"
+"<option>Etc/GMT-9</option>"
+"<option>Etc/GMT0</option>"
+"<option>Etc/Greenwich</option>"
+"<option>Etc/UCT</option>"
+"<option>Etc/UTC</option>"
+"<option>Etc/Universal</option>"
+"<option>Etc/Zulu</option>"
+"<option>Europe/Amsterdam</option>"
+"<option>Europe/Andorra</option>"
+"<option>Europe/Astrakhan</option>"
+"<option>Europe/Athens</option>"
+"<option>Europe/Belfast</option>"
+"<option>Europe/Belgrade</option>"
+"<option>Europe/Berlin</option>"
+"<option>Europe/Bratislava</option>"
+"<option>Europe/Brussels</option>"
+"<option>Europe/Bucharest</option>"
+"<option>Europe/Budapest</option>"
+"<option>Europe/Busingen</option>"
+"<option>Europe/Chisinau</option>"
+"<option>Europe/Copenhagen</option>"
+"<option>Europe/Dublin</option>"
+"<option>Europe/Gibraltar</option>"
+"<option>Europe/Guernsey</option>"
+"<option>Europe/Helsinki</option>"
+"<option>Europe/Isle_of_Man</option>"
+"<option>Europe/Istanbul</option>"
+"<option>Europe/Jersey</option>"
+"<option>Europe/Kaliningrad</option>"
+"<option>Europe/Kiev</option>"
+"<option>Europe/Kirov</option>"
+"<option>Europe/Lisbon</option>"
+"<option>Europe/Ljubljana</option>"
+"<option>Europe/London</option>"
+"<option>Europe/Luxembourg</option>"
+"<option>Europe/Madrid</option>"
+"<option>Europe/Malta</option>"
+"<option>Europe/Mariehamn</option>"
+"<option>Europe/Minsk</option>"
+"<option>Europe/Monaco</option>"
+"<option>Europe/Moscow</option>"
+"<option>Europe/Nicosia</option>"
+"<option>Europe/Oslo</option>"
+"<option>Europe/Paris</option>"
+"<option>Europe/Podgorica</option>"
+"<option>Europe/Prague</option>"
+"<option>Europe/Riga</option>"
+"<option>Europe/Rome</option>"
+"<option>Europe/Samara</option>"
+"<option>Europe/San_Marino</option>"
+"<option>Europe/Sarajevo</option>"
+"<option>Europe/Saratov</option>"
+"<option>Europe/Simferopol</option>"
+"<option>Europe/Skopje</option>"
+"<option>Europe/Sofia</option>"
+"<option>Europe/Stockholm</option>"
+"<option>Europe/Tallinn</option>"
+"<option>Europe/Tirane</option>"
+"<option>Europe/Tiraspol</option>"
+"<option>Europe/Ulyanovsk</option>"
+"<option>Europe/Uzhgorod</option>"
+"<option>Europe/Vaduz</option>"
+"<option>Europe/Vatican</option>"
+"<option>Europe/Vienna</option>"
+"<option>Europe/Vilnius</option>"
+"<option>Europe/Volgograd</option>"
+"<option>Europe/Warsaw</option>"
+"<option>Europe/Zagreb</option>"
+"<option>Europe/Zaporozhye</option>"
+"<option>Europe/Zurich</option>"
+"<option>GB</option>"
+"<option>GB-Eire</option>"
+"<option>GMT</option>"
+"<option>GMT+0</option>"
+"<option>GMT-0</option>"
+"<option>GMT0</option>"
+"<option>Greenwich</option>"
+"<option>HST</option>"
+"<option>Hongkong</option>"
+"<option>Iceland</option>"
+"<option>Indian/Antananarivo</option>"
+"<option>Indian/Chagos</option>"
+"<option>Indian/Christmas</option>"
+"<option>Indian/Cocos</option>"
+"<option>Indian/Comoro</option>"
+"<option>Indian/Kerguelen</option>"
+"<option>Indian/Mahe</option>"
+"<option>Indian/Maldives</option>"
+"<option>Indian/Mauritius</option>"
+"<option>Indian/Mayotte</option>"
+"<option>Indian/Reunion</option>"
+"<option>Iran</option>"
+"<option>Israel</option>"
+"<option>Jamaica</option>"
+"<option>Japan</option>"
+"<option>Kwajalein</option>"
+"<option>Libya</option>"
+"<option>MET</option>"
+"<option>MST</option>"
+"<option>MST7MDT</option>"
+"<option>Mexico/BajaNorte</option>"
+"<option>Mexico/BajaSur</option>"
+"<option>Mexico/General</option>"
+"<option>NZ</option>"
+"<option>NZ-CHAT</option>"
+"<option>Navajo</option>"
+"<option>PRC</option>"
+"<option>PST8PDT</option>"
+"<option>Pacific/Apia</option>"
+"<option>Pacific/Auckland</option>"
+"<option>Pacific/Bougainville</option>"
+"<option>Pacific/Chatham</option>"
+"<option>Pacific/Chuuk</option>"
+"<option>Pacific/Easter</option>"
+"<option>Pacific/Efate</option>"
+"<option>Pacific/Enderbury</option>"
+"<option>Pacific/Fakaofo</option>"
+"<option>Pacific/Fiji</option>"
+"<option>Pacific/Funafuti</option>"
+"<option>Pacific/Galapagos</option>"
+"<option>Pacific/Gambier</option>"
+"<option>Pacific/Guadalcanal</option>"
+"<option>Pacific/Guam</option>"
+"<option>Pacific/Honolulu</option>"
+"<option>Pacific/Johnston</option>"
+"<option>Pacific/Kiritimati</option>"
+"<option>Pacific/Kosrae</option>"
+"<option>Pacific/Kwajalein</option>"
+"<option>Pacific/Majuro</option>"
+"<option>Pacific/Marquesas</option>"
+"<option>Pacific/Midway</option>"
+"<option>Pacific/Nauru</option>"
+"<option>Pacific/Niue</option>"
+"<option>Pacific/Norfolk</option>"
+"<option>Pacific/Noumea</option>"
+"<option>Pacific/Pago_Pago</option>"
+"<option>Pacific/Palau</option>"
+"<option>Pacific/Pitcairn</option>"
+"<option>Pacific/Pohnpei</option>"
+"<option>Pacific/Ponape</option>"
+"<option>Pacific/Port_Moresby</option>"
+"<option>Pacific/Rarotonga</option>"
+"<option>Pacific/Saipan</option>"
+"<option>Pacific/Samoa</option>"
+"<option>Pacific/Tahiti</option>"
+"<option>Pacific/Tarawa</option>"
+"<option>Pacific/Tongatapu</option>"
+"<option>Pacific/Truk</option>"
+"<option>Pacific/Wake</option>"
+"<option>Pacific/Wallis</option>"
+"<option>Pacific/Yap</option>"
+"<option>Poland</option>"
+"<option>Portugal</option>"
+"<option>ROC</option>"
+"<option>ROK</option>"
+"<option>Singapore</option>"
+"<option>Turkey</option>"
+"<option>UCT</option>"
+"<option>US/Alaska</option>"
+"<option>US/Aleutian</option>"
+"<option>US/Arizona</option>"
+"<option>US/Central</option>"
+"<option>US/East-Indiana</option>"
+"<option>US/Eastern</option>"
+"<option>US/Hawaii</option>"
+"<option>US/Indiana-Starke</option>"
+"<option>US/Michigan</option>"
+"<option>US/Mountain</option>"
+"<option>US/Pacific</option>"
+"<option>US/Pacific-New</option>"
+"<option>US/Samoa</option>"
+"<option>UTC</option>"
+"<option>Universal</option>"
+"<option>W-SU</option>"
+"<option>WET</option>"
+"<option>Zulu</option>"
+;
+// Where each name's <option> starts in tzOptions
+static const uint16_t tzOptionOffset[] ICACHE_RODATA_ATTR = {
+0,31,60,95,126,156,186,216,246,276,306,338,373,406,435,469,
+498,529,558,595,627,657,689,721,753,783,819,847,878,910,940,972,
+1001,1035,1063,1093,1127,1157,1187,1217,1247,1278,1311,1343,1374,1406,1436,1470,
+1505,1539,1571,1603,1634,1663,1695,1724,1758,1791,1823,1857,1904,1948,1997,2039,
+2079,2122,2164,2211,2251,2294,2337,2379,2421,2451,2484,2517,2546,2576,2615,2648,
+2678,2709,2746,2780,2811,2841,2878,2916,2953,2984,3016,3050,3082,3113,3145,3179,
+3217,3249,3284,3316,3347,3379,3416,3447,3484,3515,3547,3580,3613,3646,3682,3715,
+3751,3786,3820,3854,3886,3920,3955,3987,4022,4056,4090,4121,4153,4184,4219,4264,
+4301,4341,4384,4426,4464,4506,4546,4583,4614,4646,4678,4708,4739,4783,4827,4859,
+4894,4925,4954,4990,5025,5063,5094,5126,5157,5189,5224,5258,5291,5323,5357,5388,
+5423,5459,5492,5524,5558,5593,5626,5661,5692,5725,5757,5786,5818,5862,5906,5953,
+5985,6016,6052,6087,6119,6158,6196,6231,6267,6303,6340,6376,6413,6444,6475,6508,
+6543,6575,6612,6645,6678,6716,6750,6787,6820,6850,6888,6921,6954,6987,7021,7056,
+7094,7130,7160,7196,7228,7260,7292,7326,7357,7392,7425,7457,7493,7526,7559,7601,
+7638,7672,7707,7741,7776,7814,7847,7880,7914,7950,7976,8004,8031,8059,8086,8114,
+8144,8175,8203,8232,8261,8287,8316,8345,8373,8402,8430,8460,8487,8519,8550,8581,
+8610,8637,8667,8694,8720,8747,8777,8808,8834,8862,8890,8923,8954,8980,9009,9039,
+9068,9098,9129,9156,9187,9216,9245,9276,9306,9336,9365,9398,9432,9461,9489,9516,
+9543,9572,9602,9630,9658,9687,9721,9754,9780,9806,9838,9869,9900,9927,9958,9987,
+10015,10043,10073,10104,10131,10161,10192,10227,10255,10285,10314,10342,10372,10400,10429,10456,
+10483,10518,10551,10583,10611,10641,10672,10705,10734,10762,10797,10826,10858,10891,10923,10959,
+10991,11022,11057,11090,11125,11164,11199,11232,11262,11297,11332,11370,11405,11438,11471,11503,
+11536,11566,11601,11637,11673,11703,11735,11767,11804,11836,11869,11904,11939,11970,12007,12035,
+12068,12096,12124,12144,12168,12200,12231,12272,12303,12335,12371,12402,12438,12467,12501,12536,
+12557,12577,12597,12621,12643,12664,12688,12714,12740,12767,12794,12821,12847,12873,12899,12925,
+12951,12977,13003,13029,13055,13081,13108,13135,13162,13189,13216,13242,13268,13294,13320,13346,
+13372,13398,13424,13449,13479,13503,13527,13557,13582,13615,13646,13679,13709,13740,13772,13802,
+13836,13868,13901,13933,13965,13997,14031,14061,14094,14126,14158,14193,14225,14255,14290,14318,
+14347,14377,14410,14440,14474,14504,14533,14566,14595,14625,14655,14686,14714,14743,14776,14806,
+14834,14862,14892,14926,14958,14989,15023,15053,15082,15115,15146,15176,15208,15241,15273,15302,
+15333,15363,15394,15427,15457,15487,15521,15551,15570,15594,15614,15636,15658,15679,15705,15725,
+15750,15774,15810,15840,15873,15902,15932,15965,15993,16025,16058,16089,16120,16141,16164,16188,
+16210,16236,16258,16278,16298,16322,16355,16386,16417,16436,16460,16483,16503,16527,16556,16589,
+16626,16658,16688,16719,16749,16783,16815,16844,16877,16911,16943,16979,17008,17041,17074,17109,
+17140,17174,17205,17239,17270,17300,17329,17361,17392,17426,17456,17489,17521,17552,17589,17623,
+17654,17684,17715,17746,17780,17809,17838,17869,17897,17920,17945,17965,17985,18011,18034,18054,
+18080,18108,18135,18162,18194,18221,18247,18281,18309,18337,18364,18395,18420,18440,18466,18487,
+18507,
+};
+// mtimezone[] entry for each name, so lookups are a binary search of tzOptionOffset
+static const uint16_t tzOptionZone[] ICACHE_RODATA_ATTR = {
+0,1,13,2,13,13,0,10,0,3,11,10,11,4,5,6,
+0,0,13,13,10,7,0,11,11,8,9,13,9,11,10,10,
+10,0,10,11,11,10,11,8,8,13,12,13,14,10,0,0,
+10,0,0,15,16,17,18,19,120,120,20,21,22,22,23,24,
+25,26,27,28,29,30,31,32,54,33,34,18,35,36,37,38,
+39,40,41,42,43,21,44,45,46,47,22,48,115,49,50,34,
+23,51,52,53,54,55,56,57,58,59,120,60,61,62,141,63,
+75,64,65,66,67,68,120,120,69,70,71,72,73,74,75,76,
+77,78,79,80,81,82,75,83,84,85,24,86,87,88,76,54,
+89,90,91,87,54,92,93,94,120,95,96,97,26,98,99,100,
+101,102,103,104,105,142,120,106,107,108,109,110,111,112,113,114,
+115,116,117,118,119,120,129,121,122,123,124,125,126,127,128,129,
+23,141,130,131,132,133,134,58,135,120,136,120,120,120,120,137,
+138,139,140,141,142,120,143,120,144,145,146,147,148,149,150,151,
+152,349,153,154,349,155,156,157,315,212,158,159,160,161,162,163,
+163,164,165,210,166,167,168,169,170,171,195,172,173,216,216,174,
+176,175,176,177,178,179,180,181,216,182,183,184,185,186,303,187,
+188,189,190,191,192,227,193,193,194,195,196,197,198,212,199,199,
+200,201,202,178,203,204,205,206,207,167,208,209,210,211,231,212,
+183,213,214,215,216,217,218,219,220,221,222,189,223,223,224,225,
+201,226,226,227,228,167,229,230,231,232,233,234,235,236,237,238,
+238,315,239,240,241,0,242,254,243,244,245,254,246,247,248,249,
+251,250,251,252,254,247,253,244,243,254,249,252,253,245,129,110,
+133,94,255,256,72,145,127,142,60,136,143,127,144,131,353,73,
+257,258,259,4,300,260,260,261,262,263,264,265,266,267,268,269,
+270,271,272,260,273,274,275,276,277,278,279,280,281,282,283,284,
+285,286,260,260,287,288,288,288,289,290,291,292,308,293,294,317,
+295,296,297,334,298,299,300,301,308,302,308,303,308,304,305,306,
+307,293,308,309,310,311,302,312,313,314,203,315,316,293,317,318,
+319,320,319,293,321,322,293,323,324,325,326,298,327,328,334,319,
+329,330,331,332,293,333,334,308,308,260,260,260,260,260,335,184,
+240,13,336,337,338,13,339,340,341,342,13,343,222,189,85,224,
+366,15,344,345,346,141,97,101,349,351,58,216,347,348,349,350,
+351,352,353,354,355,356,357,358,359,360,361,362,363,363,364,365,
+366,367,368,373,369,370,371,372,373,374,375,376,376,377,378,362,
+373,379,380,381,352,382,383,352,332,307,219,215,217,303,287,19,
+18,118,49,75,107,363,76,59,58,91,91,373,288,288,314,384,
+288,
+};
@@ -25,24 +25,220 @@
 #include "web.h"
 #include "password.h"
 #include "timezone.h"
+#include "static.h"
 
 
+// Response buffers are shared between all writers, allocated once
+static char webPool[WEBWRITER_POOL][WEBWRITER_BUFFLEN];
+static bool webPoolUsed[WEBWRITER_POOL];
 
+// Chunked transfer encoding framing.  Each buffer goes out as one chunk, with
+// room reserved up front for a fixed-width size line and at the end for the
+// chunk CRLF and the terminating zero-length chunk.
+#define CHUNKHDRLEN (6) // "xxxx\r\n"
+#define CHUNKTAILLEN (2) // "\r\n"
+#define CHUNKENDLEN (5) // "0\r\n\r\n"
 
-void WebPrintError(WiFiClient *client, int code)
+WebWriter::WebWriter(WiFiClient *client)
+{
+  _client = client;
+  _buff = NULL;
+  _len = 0;
+  _keepAlive = false;
+  _chunked = false;
+  _chunkStart = 0;
+  _session = NULL;
+  _gzipOK = false;
+  _ifNoneMatch = NULL;
+  _etag[0] = 0;
+  for (int i=0; i<WEBWRITER_POOL; i++) {
+    if (!webPoolUsed[i]) {
+      webPoolUsed[i] = true;
+      _buff = webPool[i];
+      break;
+    }
+  }
+}
+
+WebWriter::~WebWriter()
+{
+  end();
+  for (int i=0; i<WEBWRITER_POOL; i++) {
+    if (_buff == webPool[i]) webPoolUsed[i] = false;
+  }
+}
+
+// Everything from here on is body, sent as chunks if the connection stays open
+void WebWriter::beginBody()
+{
+  if (!_keepAlive || _chunked) return;
+  _chunked = true;
+  if (_buff) {
+    _chunkStart = _len;
+    _len += CHUNKHDRLEN;
+  }
+}
+
+// Fill in the reserved chunk header and trailer around the pending body bytes
+void WebWriter::closeChunk()
+{
+  size_t body = _len - _chunkStart - CHUNKHDRLEN;
+  if (body) {
+    char hdr[CHUNKHDRLEN + 1];
+    snprintf_P(hdr, sizeof(hdr), PSTR("%04x\r\n"), body);
+    memcpy(_buff + _chunkStart, hdr, CHUNKHDRLEN);
+    memcpy_P(_buff + _len, PSTR("\r\n"), CHUNKTAILLEN);
+    _len += CHUNKTAILLEN;
+  } else {
+    _len = _chunkStart; // Nothing to send, drop the header
+  }
+}
+
+void WebWriter::flush()
+{
+  if (!_buff) return;
+  if (_chunked) closeChunk();
+  if (_len) _client->write((const uint8_t *)_buff, _len);
+  _len = 0;
+  if (_chunked) {
+    _chunkStart = 0;
+    _len = CHUNKHDRLEN;
+  }
+}
+
+// Flush and, for chunked bodies, send the final zero-length chunk in the same segment
+void WebWriter::end()
+{
+  if (_chunked) {
+    _chunked = false;
+    if (_buff) {
+      closeChunk();
+      memcpy_P(_buff + _len, PSTR("0\r\n\r\n"), CHUNKENDLEN);
+      _len += CHUNKENDLEN;
+    } else {
+      _client->write_P(PSTR("0\r\n\r\n"), CHUNKENDLEN);
+    }
+  }
+  flush();
+}
+
+size_t WebWriter::limit()
+{
+  return _chunked ? WEBWRITER_BUFFLEN - CHUNKTAILLEN - CHUNKENDLEN : WEBWRITER_BUFFLEN;
+}
+
+// Pool exhausted, send each piece straight out (as its own chunk if needed)
+size_t WebWriter::writeDirect(const uint8_t *data, size_t len, bool pmem)
+{
+  if (!len) return 0;
+  if (_chunked) {
+    char hdr[12];
+    snprintf_P(hdr, sizeof(hdr), PSTR("%x\r\n"), len);
+    _client->write((const uint8_t *)hdr, strlen(hdr));
+  }
+  size_t ret = pmem ? _client->write_P((PGM_P)data, len) : _client->write(data, len);
+  if (_chunked) _client->write_P(PSTR("\r\n"), CHUNKTAILLEN);
+  return ret;
+}
+
+size_t WebWriter::write(uint8_t c)
+{
+  return write(&c, 1);
+}
+
+size_t WebWriter::write(const uint8_t *data, size_t len)
+{
+  if (!_buff) return writeDirect(data, len, false);
+
+  size_t sent = len;
+  while (len) {
+    size_t cnt = limit() - _len;
+    if (cnt > len) cnt = len;
+    memcpy(_buff + _len, data, cnt);
+    _len += cnt;
+    data += cnt;
+    len -= cnt;
+    if (_len == limit()) flush();
+  }
+  return sent;
+}
+
+size_t WebWriter::write_P(PGM_P data, size_t len)
+{
+  if (!_buff) return writeDirect((const uint8_t *)data, len, true);
+
+  size_t sent = len;
+  while (len) {
+    size_t cnt = limit() - _len;
+    if (cnt > len) cnt = len;
+    memcpy_P(_buff + _len, data, cnt);
+    _len += cnt;
+    data += cnt;
+    len -= cnt;
+    if (_len == limit()) flush();
+  }
+  return sent;
+}
+
+// Format straight into the response buffer when possible, avoiding the extra copy
+size_t WebWriter::printf_P(PGM_P fmt, ...)
+{
+  va_list ap;
+  int len = 0;
+
+  if (_buff) {
+    for (int tries = 0; tries < 2; tries++) {
+      va_start(ap, fmt);
+      len = vsnprintf_P(_buff + _len, limit() - _len, fmt, ap);
+      va_end(ap);
+      if (len < 0) return 0;
+      if ((size_t)len < limit() - _len) {
+        _len += len;
+        return len;
+      }
+      // Didn't fit, so push out what we have and retry into an empty buffer
+      flush();
+    }
+  } else {
+    va_start(ap, fmt);
+    len = vsnprintf_P(NULL, 0, fmt, ap);
+    va_end(ap);
+    if (len < 0) return 0;
+  }
+
+  // Unbuffered or larger than a whole buffer, format to the heap and send it along
+  char *tmp = (char *)malloc(len + 1);
+  if (!tmp) return 0;
+  va_start(ap, fmt);
+  vsnprintf_P(tmp, len + 1, fmt, ap);
+  va_end(ap);
+  size_t ret = write((const uint8_t *)tmp, len);
+  free(tmp);
+  return ret;
+}
+
+
+
+void WebPrintError(WebWriter *client, int code)
 {
   switch(code) {
+    case 200: WebPrintf(client, "200 OK"); break;
     case 301: WebPrintf(client, "301 Moved Permanently"); break;
+    case 304: WebPrintf(client, "304 Not Modified"); break;
     case 400: WebPrintf(client, "400 Bad Request"); break;
     case 401: WebPrintf(client, "401 Unauthorized"); break;
     case 404: WebPrintf(client, "404 Not Found"); break;
     case 405: WebPrintf(client, "405 Method Not Allowed"); break;
+    case 413: WebPrintf(client, "413 Payload Too Large"); break;
+    case 414: WebPrintf(client, "414 URI Too Long"); break;
+    case 503: WebPrintf(client, "503 Service Unavailable"); break;
+    case 507: WebPrintf(client, "507 Insufficient Storage"); break;
     default:  WebPrintf(client, "500 Server Error"); break;
   }
 }
 
 
-void WebError(WiFiClient *client, int code, const char *headers, bool usePMEM)
+void WebError(WebWriter *client, int code, const char *headers, bool usePMEM)
 {
   LogPrintf("+WebError: Begin, free=%d\n", ESP.getFreeHeap());
   LogPrintf(" Sending headers...\n");
@@ -52,16 +248,18 @@ void WebError(WiFiClient *client, int code, const char *headers, bool usePMEM)
   WebPrintf(client, "Cache-Control: no-cache, no-store, must-revalidate\r\n");
   WebPrintf(client, "Pragma: no-cache\r\n");
   WebPrintf(client, "Expires: 0\r\n");
-  WebPrintf(client, "Connection: close\r\n");
+  WebConnectionHeaders(client);
   LogPrintf("+WebError: Writing error headers: %08x\n", headers);
   if (headers) {
     if (!usePMEM) {
-      WebPrintf(client, "%s", headers);
+      WebPrintf(client, "%s\r\n", headers);
     } else {
       WebPrintfPSTR(client, headers);
+      WebPrintf(client, "\r\n");
     }
   }
-  WebPrintf(client, "\r\n\r\n");
+  WebPrintf(client, "\r\n");
+  client->beginBody();
   WebPrintf(client, DOCTYPE);
   WebPrintf(client, "<html><head><title>");
   WebPrintError(client, code);
@@ -74,140 +272,279 @@ void WebError(WiFiClient *client, int code, const char *headers, bool usePMEM)
 
 
 
-void WebHeaders(WiFiClient *client, PGM_P /*const char **/headers)
+// Persistent connections need chunked framing since pages are streamed w/o a known length
+void WebConnectionHeaders(WebWriter *client)
+{
+  if (client->keepAlive()) {
+    WebPrintf(client, "Connection: keep-alive\r\n");
+    WebPrintf(client, "Keep-Alive: timeout=%d, max=%d\r\n", WEB_KEEPALIVE_MS/1000, WEB_KEEPALIVE_MAXREQ);
+    WebPrintf(client, "Transfer-Encoding: chunked\r\n");
+  } else {
+    WebPrintf(client, "Connection: close\r\n");
+  }
+  if (client->session()) {
+    WebPrintf(client, "Set-Cookie: psid=%s; Path=/; Max-Age=%ld; Secure; HttpOnly; SameSite=Strict\r\n", client->session(), SESSION_IDLE_MS / 1000);
+  }
+}
+
+// Tagged responses may be cached but must be checked with us, anything else is never kept
+static void WebCacheHeaders(WebWriter *client, unsigned long maxAge)
+{
+  if (client->etag()[0]) {
+    if (maxAge) WebPrintf(client, "Cache-Control: max-age=%lu\r\n", maxAge)
+    else WebPrintf(client, "Cache-Control: no-cache\r\n");
+    WebPrintf(client, "ETag: %s\r\n", client->etag());
+  } else {
+    WebPrintf(client, "Cache-Control: no-cache, no-store, must-revalidate\r\n");
+    WebPrintf(client, "Pragma: no-cache\r\n");
+    WebPrintf(client, "Expires: 0\r\n");
+  }
+}
+
+// Tag the response, and if the client already has it send just the headers of a 304
+static bool WebCheckETag(WebWriter *client, const char *etag, unsigned long maxAge)
+{
+  client->setETag(etag);
+  const char *match = client->ifNoneMatch();
+  if (!match || !strstr(match, etag)) return false;
+  WebPrintf(client, "HTTP/1.1 304 Not Modified\r\n");
+  WebPrintf(client, "Server: PsychoPlug\r\n");
+  WebCacheHeaders(client, maxAge);
+  WebConnectionHeaders(client);
+  WebPrintf(client, "\r\n"); // No body, so no chunks either
+  return true;
+}
+
+bool WebNotModified(WebWriter *client, uint32_t version)
+{
+  // Versions start over at each boot, so add something that doesn't
+  static uint32_t bootTag = 0;
+  if (!bootTag) bootTag = RANDOM_REG32 | 1;
+  char etag[20];
+  snprintf_P(etag, sizeof(etag), PSTR("\"%08lx%08lx\""), (unsigned long)bootTag, (unsigned long)version);
+  return WebCheckETag(client, etag, 0);
+}
+
+void WebHeaders(WebWriter *client, PGM_P /*const char **/headers)
 {
   WebPrintf(client, "HTTP/1.1 200 OK\r\n");
   WebPrintf(client, "Server: PsychoPlug\r\n");
   WebPrintf(client, "Content-type: text/html\r\n");
-  WebPrintf(client, "Cache-Control: no-cache, no-store, must-revalidate\r\n");
-  WebPrintf(client, "Pragma: no-cache\r\n");
-  WebPrintf(client, "Connection: close\r\n");
-  WebPrintf(client, "Expires: 0\r\n");
+  WebCacheHeaders(client, 0);
+  WebConnectionHeaders(client);
   if (headers) {
     WebPrintfPSTR(client, headers);
   }
   WebPrintf(client, "\r\n");
+  client->beginBody();
+}
+
+// API responses, errors included, are small JSON documents
+void WebJSONHeaders(WebWriter *client, int code)
+{
+  WebPrintf(client, "HTTP/1.1 ");
+  WebPrintError(client, code);
+  WebPrintf(client, "\r\n");
+  WebPrintf(client, "Server: PsychoPlug\r\n");
+  WebPrintf(client, "Content-type: application/json\r\n");
+  if (code == 200) WebCacheHeaders(client, 0);
+  else WebPrintf(client, "Cache-Control: no-cache, no-store, must-revalidate\r\n");
+  WebConnectionHeaders(client);
+  WebPrintf(client, "\r\n");
+  client->beginBody();
+}
+
+// Quoted JSON string, escaping anything that would break the document
+void WebJSONString(WebWriter *client, const char *str)
+{
+  client->write('"');
+  for (; *str; str++) {
+    if (*str == '"' || *str == '\\') {
+      client->write('\\');
+      client->write(*str);
+    } else if ((unsigned char)*str < ' ') {
+      WebPrintf(client, "\\u%04x", *str);
+    } else {
+      client->write(*str);
+    }
+  }
+  client->write('"');
 }
 
 
 
+// Parser states
+#define REQ_LINE    (0)
+#define REQ_HEADERS (1)
+#define REQ_ROUTE   (2) // Headers done, waiting on the caller
+#define REQ_BODY    (3)
+#define REQ_DONE    (4)
 
-// In-place decoder, overwrites source with decoded values.  Needs 0-termination on input
-// Try and keep memory needs low, speed not critical
-static uint8_t b64lut(uint8_t i)
+// Unread bytes in rxBuff are kept, they may be the start of a pipelined request
+void WebRequestBegin(WebRequest *req)
 {
-  if (i >= 'A' && i <= 'Z') return i - 'A';
-  if (i >= 'a' && i <= 'z') return i - 'a' + 26;
-  if (i >= '0' && i <= '9') return i - '0' + 52;
-  if (i == '-') return 62;
-  if (i == '_') return 63;
-  else return 64;// sentinel
+  req->state = REQ_LINE;
+  req->connClose = false;
+  req->skipLine = false;
+  req->tooLong = false;
+  req->gzipOK = false;
+  req->streamForm = false;
+  req->newSession = false;
+  req->takesCookies = false;
+  req->keepAlive = false;
+  req->url = NULL;
+  req->params = NULL;
+  req->reqLen = 0;
+  req->bodyOff = 0;
+  req->bodyLeft = 0;
+  req->reqBuff[0] = 0;
+  req->authBuff[0] = 0; // Start w/o authorization hdr
+  req->sessBuff[0] = 0;
+  req->etag[0] = 0;
+  req->startMS = millis();
+  req->lastByteMS = req->startMS;
 }
 
-void Base64Decode(char *str)
+bool WebRequestIdle(WebRequest *req)
 {
-  char *dest;
-  dest = str;
+  return (req->state == REQ_LINE) && (req->reqLen == 0) && (req->rxLen == 0);
+}
 
-  if (strlen(str)%4) return; // Not multiple of 4 == error
-  
-  while (*str) {
-    uint8_t a = b64lut(*(str++));
-    uint8_t b = b64lut(*(str++));
-    uint8_t c = b64lut(*(str++));
-    uint8_t d = b64lut(*(str++));
-    *(dest++) = (a << 2) | ((b & 0x30) >> 4);
-    if (c == 64) break;
-    *(dest++) = ((b & 0x0f) << 4) | ((c & 0x3c) >> 2);
-    if (d == 64) break;
-    *(dest++) = ((c & 0x03) << 6) | d;
-  }
-  *dest = 0; // Terminate the string
-}
-
-
-void URLDecode(char *ptr)
-{
-  while (*ptr) {
-    if (*ptr == '+') {
-      *ptr = ' ';
-    } else if (*ptr == '%') {
-      if (*(ptr+1) && *(ptr+2)) {
-        byte a = *(ptr + 1);
-        byte b = *(ptr + 2);
-        if (a>='0' && a<='9') a -= '0';
-        else if (a>='a' && a<='f') a = a - 'a' + 10;
-        else if (a>='A' && a<='F') a = a - 'A' + 10;
-        if (b>='0' && b<='9') b -= '0';
-        else if (b>='a' && b<='f') b = b - 'a' + 10;
-        else if (b>='A' && b<='F') b = b - 'A' + 10;
-        *ptr = ((a&0x0f)<<4) | (b&0x0f);
-        // Safe strcpy the rest of the string back
-        char *p1 = ptr + 1;
-        char *p2 = ptr + 3;
-        while (*p2) { *p1 = *p2; p1++; p2++; }
-        *p1 = 0;
-      }
-      // OTW this is a bad encoding, just pass unchanged
-    }
-    ptr++;
-  }
+bool WebRequestPost(WebRequest *req)
+{
+  return !memcmp_P(req->reqBuff, PSTR("POST "), 5);
 }
 
+// Case insensitive match of a header name we've found the length of
+static bool WebHeaderIs(const char *name, int len, PGM_P want)
+{
+  return ((int)strlen_P(want) == len) && !strncasecmp_P(name, want, len);
+}
 
+// Handle one complete header line, in place in the receive buffer
+static void WebParseHeader(WebRequest *req, char *line)
+{
+  char *colon = strchr(line, ':');
+  if (!colon) return;
+  int nameLen = colon - line;
+  char *value = colon + 1;
+  while (*value == ' ' || *value == '\t') value++;
+
+  if (WebHeaderIs(line, nameLen, PSTR("Authorization"))) {
+    if (!strncmp_P(value, PSTR("Basic "), 6)) {
+      strlcpy(req->authBuff, value + 6, sizeof(req->authBuff));
+    } else if (!strncmp_P(value, PSTR("Bearer "), 7)) {
+      strlcpy(req->sessBuff, value + 7, sizeof(req->sessBuff));
+    }
+  } else if (WebHeaderIs(line, nameLen, PSTR("Content-Length"))) {
+    req->bodyLeft = atol(value);
+  } else if (WebHeaderIs(line, nameLen, PSTR("Connection"))) {
+    for (char *p = value; *p; p++) *p = tolower(*p);
+    if (strstr_P(value, PSTR("close"))) req->connClose = true;
+  } else if (WebHeaderIs(line, nameLen, PSTR("Cookie"))) {
+    req->takesCookies = true;
+    char *p = strstr_P(value, PSTR("psid="));
+    if (p) {
+      strlcpy(req->sessBuff, p + 5, sizeof(req->sessBuff));
+      char *end = strchr(req->sessBuff, ';');
+      if (end) *end = 0;
+    }
+  } else if (WebHeaderIs(line, nameLen, PSTR("If-None-Match"))) {
+    strlcpy(req->etag, value, sizeof(req->etag));
+  } else if (WebHeaderIs(line, nameLen, PSTR("Accept"))) {
+    if (strstr_P(value, PSTR("text/html"))) req->takesCookies = true; // A browser loading a page
+  } else if (WebHeaderIs(line, nameLen, PSTR("Accept-Encoding"))) {
+    for (char *p = value; *p; p++) *p = tolower(*p);
+    if (strstr_P(value, PSTR("gzip"))) req->gzipOK = true;
+  }
+}
 
-// Parse (authenticated) HTTP request, request authentication if not authorized
-bool WebReadRequest(WiFiClient *client, char **urlStr, char **paramStr, bool authReq, const char *uiUser, const char *uiSalt, const char *uiPassEnc)
+// Handle the request line, a header, or the blank line ending them
+static void WebParseLine(WebRequest *req, char *line)
 {
-  static char NUL = 0; // Get around writable strings...
-  char hdrBuff[128];
-  char authBuff[128];
-  char reqBuff[384];
+  if (req->state == REQ_LINE) {
+    if (!line[0]) return; // Stray CRLF between requests
+    req->reqLen = strlcpy(req->reqBuff, line, sizeof(req->reqBuff) - 1); // Leave room for an empty body
+    if (req->reqLen > (int)sizeof(req->reqBuff) - 2) req->reqLen = sizeof(req->reqBuff) - 2;
+    req->state = REQ_HEADERS;
+  } else if (line[0]) {
+    WebParseHeader(req, line);
+  } else {
+    // Blank line, end of headers.  In a POST the params follow in the body
+    req->reqLen++; // Body goes after the request line's \0
+    req->bodyOff = req->reqLen;
+    req->reqBuff[req->reqLen] = 0;
+    if (!WebRequestPost(req)) req->bodyLeft = 0; // Only POSTs have bodies we'll look at
+    req->state = REQ_ROUTE;
+  }
+}
 
-  *urlStr = NULL;
-  *paramStr = NULL;
+// Drop the first len bytes of the receive buffer
+static void WebRxConsume(WebRequest *req, int len)
+{
+  req->rxLen -= len;
+  memmove(req->rxBuff, req->rxBuff + len, req->rxLen);
+}
 
-  LogPrintf("+WebReadRequest @ %d\n", millis());
-  unsigned long timeoutMS = millis() + 5000; // Max delay before we timeout
-  while (!client->available() && millis() < timeoutMS) { delay(10); }
-  if (!client->available()) {
-    LogPrintf("-WebReadRequest: Timeout @ %d\n", millis());
-    return false;
+// Scan the receive buffer for complete lines in place, leaving any partial line
+static void WebParseLines(WebRequest *req)
+{
+  char *line = req->rxBuff;
+  char *end = req->rxBuff + req->rxLen;
+  while (req->state == REQ_LINE || req->state == REQ_HEADERS) {
+    char *nl = (char *)memchr(line, '\n', end - line);
+    if (!nl) break;
+    char *eol = (nl > line && nl[-1] == '\r') ? nl - 1 : nl;
+    *eol = 0;
+    if (req->skipLine) req->skipLine = false;
+    else WebParseLine(req, line);
+    line = nl + 1;
   }
-  int wlen = client->readBytesUntil('\r', reqBuff, sizeof(reqBuff)-1);
-  reqBuff[wlen] = 0;
-
-  int hlen = 0;
-  authBuff[0] = 0; // Start w/o authorization hdr
-  // Parse through all headers until \r\n\r\n
-  do {
-    uint8_t newline;
-    client->read(&newline, 1); // Get rid of \n
-    hlen = (byte)client->readBytesUntil('\r', hdrBuff, sizeof(hdrBuff)-1);
-    hdrBuff[hlen] = 0;
-    if (!strncmp_P(hdrBuff, PSTR("Authorization: Basic "), 21)) {
-      strncpy(authBuff, hdrBuff, sizeof(authBuff));
+  WebRxConsume(req, line - req->rxBuff);
+  if ((req->state == REQ_LINE || req->state == REQ_HEADERS) && req->rxLen == (int)sizeof(req->rxBuff)) {
+    // A line longer than the whole buffer.  No header we use is that long, so skip it
+    if (req->state == REQ_LINE) {
+      req->tooLong = true;
+      req->reqBuff[0] = 0;
+      req->state = REQ_HEADERS;
     }
-  } while (hlen > 0);
+    req->skipLine = true;
+    req->rxLen = 0;
+  }
+}
 
-  // Check for no password...
-  bool empty = true;
-  for (unsigned int i=0; uiSalt!=NULL && i<SALTLEN; i++) if (uiSalt[i]) empty = false;
-  if (authReq && uiUser && uiUser[0] && !empty) {
-    Base64Decode(authBuff+21);
-    char *user = authBuff+21;
-    char *pass = user;
-    while (*pass && *pass != ':') pass++; // Advance to the : or \0
-    if (*pass) { *pass = 0; pass++; } // Skip the :, end the user string
-    bool matchUser = !strcmp(user, uiUser);
-    bool matchPass = VerifyPassword(pass, uiSalt, uiPassEnc);
-    if (!authBuff[0] || !matchUser || !matchPass) {
-      LogPrintf("WebReadRequest: Unauthenticated\n");
-      WebError(client, 401, PSTR("WWW-Authenticate: Basic realm=\"PsychoPlug\""));
-      return false;
-    }
+// POST body bytes go through the form parser, or after the request line with anything past the buffer dropped
+static void WebParseBody(WebRequest *req, const char *data, int len)
+{
+  if (req->streamForm) {
+    FormFeed(&req->form, data, len);
+  } else {
+    int room = sizeof(req->reqBuff) - 1 - req->reqLen;
+    if (len > room) req->tooLong = true;
+    memcpy(req->reqBuff + req->reqLen, data, (len < room) ? len : room);
+    req->reqLen += (len < room) ? len : room;
+    req->reqBuff[req->reqLen] = 0;
   }
-  
+  req->bodyLeft -= len;
+  if (req->bodyLeft <= 0) req->state = REQ_DONE;
+}
+
+void WebRequestForm(WebRequest *req, FormHandler handler)
+{
+  if (req->state != REQ_ROUTE || !WebRequestPost(req)) return; // GETs keep their query string
+  FormBegin(&req->form, req->reqBuff + req->bodyOff, sizeof(req->reqBuff) - req->bodyOff, handler);
+  req->streamForm = true;
+}
+
+// Headers are done, split the request line into the decoded URL and any query string
+static bool WebParseTarget(WebRequest *req)
+{
+  static char NUL = 0; // Get around writable strings...
+  char *reqBuff = req->reqBuff;
+
+  // Only HTTP/1.1 clients understand the chunked responses we need to stay open
+  req->keepAlive = !req->connClose && strstr_P(reqBuff, PSTR(" HTTP/1.1"));
+
   // Delete HTTP version (well, anything after the 2nd space)
   char *ptr = reqBuff;
   while (*ptr && *ptr!=' ') ptr++;
@@ -215,104 +552,359 @@ bool WebReadRequest(WiFiClient *client, char **urlStr, char **paramStr, bool aut
   while (*ptr && *ptr!=' ') ptr++;
   *ptr = 0;
 
-  URLDecode(reqBuff);
-
   char *url;
   char *qp;
   if (!memcmp_P(reqBuff, PSTR("GET "), 4)) {
-    client->flush(); // Don't need anything here...
-    
-    // Break into URL and form data
     url = reqBuff+4;
-    while (*url && *url=='/') url++; // Strip off leading /s
-    qp = strchr(url, '?');
-    if (qp) {
-      *qp = 0; // End URL
-      qp++;
-    } else {
-      qp = &NUL;
-    }
   } else if (!memcmp_P(reqBuff, PSTR("POST "), 5)) {
-    uint8_t newline;
-    client->read(&newline, 1); // Get rid of \n
-
     url = reqBuff+5;
-    while (*url && *url=='/') url++; // Strip off leading /s
-    qp = strchr(url, '?');
-    if (qp) *qp = 0; // End URL @ ?
-    // In a POST the params are in the body
-    int sizeleft = sizeof(reqBuff) - strlen(reqBuff) - 1;
-    qp = reqBuff + strlen(reqBuff) + 1;
-    int wlen = client->readBytesUntil('\r', qp, sizeleft-1);
-    qp[wlen] = 0;
-    client->flush();
-    URLDecode(qp);
   } else {
-    // Not a GET or POST, error
-    WebError(client, 405, PSTR("Allow: GET, POST"));
-    LogPrintf("-WebReadRequest(): Illegal command\n");
     return false;
   }
+  // Break into URL and form data
+  while (*url && *url=='/') url++; // Strip off leading /s
+  qp = strchr(url, '?');
+  if (qp) {
+    *qp = 0; // End URL
+    qp++;
+  } else {
+    qp = &NUL;
+  }
+  URLDecode(url); // Params are decoded as they're split up by ParseParam()
+  // In a POST the params are in the body, after the request line
+  if (WebRequestPost(req)) qp = reqBuff + req->bodyOff;
 
-  if (urlStr) *urlStr = url;
-  if (paramStr) *paramStr = qp;
+  req->url = url;
+  req->params = qp;
+  return true;
+}
+
+// Parse an HTTP request as its bytes arrive.  Returns WEBREQ_HEADERS once when
+// the headers are done so the caller can route and authorize the request (and
+// maybe call WebRequestForm()) before reading any body.
+int WebReadRequest(WiFiClient *client, WebRequest *req, char **urlStr, char **paramStr, bool *keepAlive)
+{
+  *urlStr = NULL;
+  *paramStr = NULL;
+  if (keepAlive) *keepAlive = false;
+
+  if (req->state == REQ_ROUTE) {
+    // Caller has seen the headers, on to the body
+    req->state = (WebRequestPost(req) && req->bodyLeft > 0) ? REQ_BODY : REQ_DONE;
+  }
 
+  // Take whatever has arrived in as few reads as possible, but never wait for more
+  while (req->state != REQ_DONE && req->state != REQ_ROUTE) {
+    if (req->state == REQ_BODY) {
+      if (req->rxLen) {
+        // Body bytes that came in with the headers
+        int len = (req->rxLen < req->bodyLeft) ? req->rxLen : req->bodyLeft;
+        WebParseBody(req, req->rxBuff, len);
+        WebRxConsume(req, len);
+        continue;
+      }
+    } else {
+      WebParseLines(req);
+      if (req->state == REQ_ROUTE) break;
+    }
+
+    int avail = client->available();
+    if (avail <= 0) break;
+    int space = sizeof(req->rxBuff) - req->rxLen;
+    // Never read past the body, anything after it belongs to the next request
+    if (req->state == REQ_BODY && req->bodyLeft < space) space = req->bodyLeft;
+    if (avail > space) avail = space;
+    if (WebRequestIdle(req)) req->startMS = millis(); // Request timeout runs from the first byte
+    int len = client->read((uint8_t *)req->rxBuff + req->rxLen, avail);
+    if (len <= 0) break;
+    req->rxLen += len;
+    req->lastByteMS = millis();
+  }
+
+  if (req->state == REQ_ROUTE) {
+    LogPrintf("+WebReadRequest @ %d\n", millis());
+    bool ok = WebParseTarget(req);
+    if (keepAlive) *keepAlive = req->keepAlive;
+    if (req->tooLong || !ok) {
+      // Can't answer it, and any body hasn't been read so hang up after
+      WebWriter out(client);
+      if (req->tooLong) {
+        WebError(&out, 414, NULL);
+        LogPrintf("-WebReadRequest(): URI too long\n");
+      } else {
+        WebError(&out, 405, PSTR("Allow: GET, POST"));
+        LogPrintf("-WebReadRequest(): Illegal command\n");
+      }
+      if (keepAlive) *keepAlive = false;
+      return WEBREQ_FAILED;
+    }
+    *urlStr = req->url;
+    return WEBREQ_HEADERS;
+  }
+
+  if (req->state != REQ_DONE) {
+    if (WebRequestIdle(req)) {
+      // Nothing sent yet, this is the keep-alive idle timeout
+      if (millis() - req->startMS > WEB_KEEPALIVE_MS) return WEBREQ_FAILED;
+    } else if (millis() - req->startMS > WEB_REQUEST_TIMEOUT_MS) {
+      LogPrintf("-WebReadRequest: Timeout @ %d\n", millis());
+      return WEBREQ_FAILED;
+    }
+    return WEBREQ_PENDING;
+  }
+
+  if (keepAlive) *keepAlive = req->keepAlive;
+  if (req->streamForm) {
+    FormEnd(&req->form);
+    if (req->form.dropped) LogPrintf("WebReadRequest: %d form fields too long, dropped\n", req->form.dropped);
+    req->params = req->form.buff + req->form.size - 1; // Already handled, so none left
+    *req->params = 0;
+  } else if (req->tooLong) {
+    WebWriter out(client);
+    out.setKeepAlive(req->keepAlive);
+    WebError(&out, 413, NULL);
+    LogPrintf("-WebReadRequest(): Body too large\n");
+    return WEBREQ_FAILED;
+  }
+
+  *urlStr = req->url;
+  *paramStr = req->params;
   LogPrintf("-WebReadRequest(): Success\n");
-  return true;
+  return WEBREQ_READY;
 }
 
+// Cost of each authentication method, in microseconds
+static unsigned long authBasicCount = 0;
+static unsigned long authBasicUS = 0;
+static unsigned long authSessCount = 0;
+static unsigned long authSessUS = 0;
+// Sessions handed out, and requests they let skip the password check
+static unsigned long sessCreated = 0;
+static unsigned long sessReused = 0;
+static unsigned long sessLastMS = 0;
+
+void WebAuthStats(unsigned long *basicCount, unsigned long *basicUS, unsigned long *sessCount, unsigned long *sessUS)
+{
+  *basicCount = authBasicCount;
+  *basicUS = authBasicUS;
+  *sessCount = authSessCount;
+  *sessUS = authSessUS;
+}
 
+void WebSessionStats(unsigned long *created, unsigned long *reused)
+{
+  *created = sessCreated;
+  *reused = sessReused;
+}
 
-// Scan out and update a pointeinto the param string, returning the name and value or false if done
-bool ParseParam(char **paramStr, char **name, char **value)
+// Check the request's session token or Basic authorization, if a user and password are set.
+// A good Basic login starts a new session, sent back as a cookie, but only for clients that
+// look like they'll send it back and no more than one per WEB_SESSION_NEW_MS.  Otherwise a
+// poller that ignores cookies would evict everyone else's sessions and pay for an HMAC each time.
+bool WebAuthenticate(WebWriter *out, WebRequest *req, const char *uiUser, const char *uiSalt, const char *uiPassEnc)
 {
-  char *data = *paramStr;
- 
-  if (*data==0) return false;
-  
-  char *namePtr = data;
-  while ((*data != 0) && (*data != '=') && (*data != '&')) data++;
-  if (*data) { *data = 0; data++; }
-  char *valPtr = data;
-  if  (*data == '=') data++;
-  while ((*data != 0) && (*data != '=') && (*data != '&')) data++;
-  if (*data) { *data = 0; data++;}
-  
-  *paramStr = data;
-  *name = namePtr;
-  *value = valPtr;
+  char *authBuff = req->authBuff;
 
-  return true;
+  // Check for no password...
+  bool empty = true;
+  for (unsigned int i=0; uiSalt!=NULL && i<SALTLEN; i++) if (uiSalt[i]) empty = false;
+  if (!uiUser || !uiUser[0] || empty) return true;
+
+  if (req->sessBuff[0]) {
+    unsigned long startUS = micros();
+    bool ok = SessionCheck(req->sessBuff);
+    authSessUS += micros() - startUS;
+    authSessCount++;
+    if (ok) {
+      sessReused++;
+      return true;
+    }
+  }
+
+  if (authBuff[0]) {
+    unsigned long startUS = micros();
+    Base64Decode(authBuff);
+    char *user = authBuff;
+    char *pass = user;
+    while (*pass && *pass != ':') pass++; // Advance to the : or \0
+    if (*pass) { *pass = 0; pass++; } // Skip the :, end the user string
+    bool matchUser = !strcmp(user, uiUser);
+    bool matchPass = VerifyPassword(pass, uiSalt, uiPassEnc);
+    authBuff[0] = 0; // Decoded in place, can't be checked twice
+    authBasicUS += micros() - startUS;
+    authBasicCount++;
+    if (matchUser && matchPass) {
+      // Hand out a session with the response, sessBuff is free now
+      if (req->takesCookies && (!sessCreated || (millis() - sessLastMS >= WEB_SESSION_NEW_MS))) {
+        strlcpy(req->sessBuff, SessionCreate(), sizeof(req->sessBuff));
+        req->newSession = true;
+        sessCreated++;
+        sessLastMS = millis();
+      }
+      return true;
+    }
+  }
+  LogPrintf("WebAuthenticate: Unauthenticated\n");
+  WebError(out, 401, PSTR("WWW-Authenticate: Basic realm=\"PsychoPlug\""));
+  return false;
+}
+
+
+
+// Route hash index, entries are 1 + the route's table position, 0 for empty
+#define WEB_ROUTE_BUCKETS (64)
+static const WebRoute *webRoutes;
+static byte webRouteIndex[WEB_ROUTE_BUCKETS];
+static byte webRouteDefault[4]; // Catch-all per server bit, same encoding
+
+// Same as WebHash(), but iterative for run-time strings
+static uint32_t WebHashStr(const char *str)
+{
+  uint32_t hash = 2166136261UL;
+  while (*str) hash = (hash ^ (uint8_t)*(str++)) * 16777619UL;
+  return hash;
+}
+
+static void WebReadRoute(int idx, WebRoute *route)
+{
+  memcpy_P(route, &webRoutes[idx], sizeof(*route));
+}
+
+void WebRoutesBegin(const WebRoute *routes, int count)
+{
+  webRoutes = routes;
+  memset(webRouteIndex, 0, sizeof(webRouteIndex));
+  memset(webRouteDefault, 0, sizeof(webRouteDefault));
+  for (int i=0; i<count && i<255; i++) {
+    WebRoute r;
+    WebReadRoute(i, &r);
+    if (r.flags & ROUTE_DEFAULT) {
+      for (int s=0; s<4; s++) {
+        if (r.servers & (1<<s)) webRouteDefault[s] = i + 1;
+      }
+      continue;
+    }
+    // Open addressing, linear probe.  The same path may appear once per server and
+    // method, and is the same flash array each time it does
+    int b = r.hash % WEB_ROUTE_BUCKETS;
+    int probes = 0;
+    while (webRouteIndex[b] && probes < WEB_ROUTE_BUCKETS) {
+      WebRoute o;
+      WebReadRoute(webRouteIndex[b] - 1, &o);
+      if (o.hash == r.hash && (o.servers & r.servers) && (o.flags & r.flags & ROUTE_ANY) && o.path == r.path) {
+        LogPrintf("WebRoutesBegin: Route %d duplicates %d\n", i, webRouteIndex[b] - 1);
+      }
+      b = (b + 1) % WEB_ROUTE_BUCKETS;
+      probes++;
+    }
+    if (probes == WEB_ROUTE_BUCKETS) {
+      LogPrintf("WebRoutesBegin: Index full, increase WEB_ROUTE_BUCKETS\n");
+      return;
+    }
+    webRouteIndex[b] = i + 1;
+  }
+}
+
+int WebFindRoute(const char *url, byte server, bool post, WebRoute *route)
+{
+  byte method = post ? ROUTE_POST : ROUTE_GET;
+  uint32_t hash = WebHashStr(url);
+  int badMethod = 0;
+  for (int b = hash % WEB_ROUTE_BUCKETS, probes = 0; webRouteIndex[b] && probes < WEB_ROUTE_BUCKETS; b = (b + 1) % WEB_ROUTE_BUCKETS, probes++) {
+    WebRoute r;
+    WebReadRoute(webRouteIndex[b] - 1, &r);
+    if (r.hash != hash || !(r.servers & server) || strcmp_P(url, r.path)) continue;
+    if (r.flags & method) {
+      *route = r;
+      return WEBROUTE_FOUND;
+    }
+    badMethod = webRouteIndex[b]; // Keep looking, another entry may take this method
+  }
+  if (badMethod) {
+    WebReadRoute(badMethod - 1, route);
+    return WEBROUTE_BADMETHOD;
+  }
+
+  // No such path, use the server's catch-all
+  for (int s=0; s<4; s++) {
+    if ((server & (1<<s)) && webRouteDefault[s]) {
+      WebReadRoute(webRouteDefault[s] - 1, route);
+      return WEBROUTE_FOUND;
+    }
+  }
+  return WEBROUTE_NOTFOUND;
 }
 
-bool IsIndexHTML(const char *url)
+
+
+static unsigned long webLatency[WEB_LATENCY_BUCKETS];
+
+void WebConnOpen(WebConn *conn, WiFiClient *client, bool secure)
 {
-  if (!url) return false;
-  if (*url==0 || !strcmp_P(url, PSTR("/")) || !strcmp_P(url, PSTR("/index.html")) || !strcmp_P(url, PSTR("index.html"))) return true;
-  else return false;
+  conn->client = client;
+  conn->secure = secure;
+  conn->requests = 0;
+  conn->streaming = false;
+  conn->req.rxLen = 0;
+  WebRequestBegin(&conn->req);
 }
 
+void WebConnClose(WebConn *conn)
+{
+  if (!conn->client) return;
+  conn->client->flush();
+  conn->client->stop();
+  delete conn->client;
+  conn->client = NULL;
+}
+
+void WebConnServed(WebConn *conn)
+{
+  unsigned long ms = millis() - conn->req.startMS;
+  conn->requests++;
+  conn->served++;
+  conn->totalMS += ms;
+  if (ms > conn->maxMS) conn->maxMS = ms;
+
+  int bucket = 0;
+  while ((bucket < WEB_LATENCY_BUCKETS - 1) && (ms >= (2UL << bucket))) bucket++;
+  webLatency[bucket]++;
+}
 
+unsigned long WebLatencyPercentile(int pct)
+{
+  unsigned long total = 0;
+  for (int i=0; i<WEB_LATENCY_BUCKETS; i++) total += webLatency[i];
+  if (!total) return 0;
+
+  unsigned long want = (total * pct + 99) / 100;
+  unsigned long sum = 0;
+  for (int i=0; i<WEB_LATENCY_BUCKETS; i++) {
+    sum += webLatency[i];
+    if (sum >= want) return 2UL << i;
+  }
+  return 2UL << (WEB_LATENCY_BUCKETS - 1);
+}
 
 
 
-void WebFormText(WiFiClient *client, /*const char **/ PGM_P label, const char *name, const char *value, bool enabled)
+void WebFormText(WebWriter *client, /*const char **/ PGM_P label, const char *name, const char *value, bool enabled)
 {
   WebPrintfPSTR(client, label);
   WebPrintf(client, ": <input type=\"text\" name=\"%s\" id=\"%s\" value=\"%s\" %s><br>\n", name, name, value, !enabled?"disabled":"");
 }
-void WebFormText(WiFiClient *client, /*const char **/ PGM_P label, const char *name, const int value, bool enabled)
+void WebFormText(WebWriter *client, /*const char **/ PGM_P label, const char *name, const int value, bool enabled)
 {
   WebPrintfPSTR(client, label);
   WebPrintf(client, ": <input type=\"text\" name=\"%s\" id=\"%s\" value=\"%d\" %s><br>\n", name, name, value, !enabled?"disabled":"");
 }
-void WebFormCheckbox(WiFiClient *client, /*const char **/ PGM_P label, const char *name, bool checked, bool enabled)
+void WebFormCheckbox(WebWriter *client, /*const char **/ PGM_P label, const char *name, bool checked, bool enabled)
 {
   WebPrintf(client, "<input type=\"checkbox\" name=\"%s\" id=\"%s\" %s %s> ", name, name, checked?"checked":"", !enabled?"disabled":"");
   WebPrintfPSTR(client, label);
   WebPrintf(client, "<br>\n");
 }
-void WebFormCheckboxDisabler(WiFiClient *client, PGM_P /*const char **/label, const char *name, bool invert, bool checked, bool enabled, const char *ids[])
+void WebFormCheckboxDisabler(WebWriter *client, PGM_P /*const char **/label, const char *name, bool invert, bool checked, bool enabled, const char *ids[])
 {
   WebPrintf(client,"<input type=\"checkbox\" name=\"%s\" id=\"%s\" onclick=\"", name,name);
   if (invert) WebPrintf(client, "var x = true; if (this.checked) { x = false; }\n")
@@ -325,99 +917,67 @@ void WebFormCheckboxDisabler(WiFiClient *client, PGM_P /*const char **/label, co
   WebPrintf(client, "<br>\n");
 }
 
-// We do the sort in the browser because it has more memory than us. :(
-void WebTimezonePicker(WiFiClient *client, const char *timezone)
+// Timezone drop-down with the current zone selected
+void WebTimezonePicker(WebWriter *client, const char *timezone)
 {
-  bool reset = true;
+  // The list is already sorted and formatted in flash, just mark the current zone
+  int len;
+  PGM_P options = GetTZOptions(&len);
+  int sel = FindTZOption(timezone);
   WebPrintf(client, "Timezone: <select name=\"tz\" id=\"tz\">\n");
-  char str[64];
-  char temp[128];
-  char *buff = (char *)malloc(1400); // We'll combine a bunch of TZs into a single packet this way, way faster to send
-  if (buff) {
-    buff[0] = 0;
-    int len = 0;
-    while ( GetNextTZ(reset, str, sizeof(str)) ) {
-        reset = false;
-        snprintf_P(temp, sizeof(temp), PSTR("<option value=\"%s\" %s>%s</option>\n"), str, !strcmp(str, timezone)?"selected":"", str);
-        if (len + strlen(temp) > 1399) {
-          client->print(buff);
-          buff[0] = 0;
-          len = 0;
-        }
-        strcpy(buff+len, temp);
-        len += strlen(temp);
-    }
-    if (len) {
-      client->print(buff);
-      delay(0);
-    }
-  } else { // Can't allocate buff, fall back to standard way
-    while ( GetNextTZ(reset, str, sizeof(str)) ) {
-      reset = false;
-      WebPrintf(client, "<option value=\"%s\" %s>%s</option>\n", str, !strcmp(str, timezone)?"selected":"", str);
-    }
+  if (sel >= 0) {
+    client->write_P(options, sel);
+    WebPrintf(client, " selected");
+    client->write_P(options + sel, len - sel);
+  } else {
+    client->write_P(options, len);
   }
   WebPrintf(client, "</select><br>\n");
-  free(buff);
-
-  // Javascript to sort alphabetically...
-  WebPrintf(client, "<script type=\"text/javascript\">\n");
-  WebPrintf(client, "function sortSelect(selElem) { \n");
-  WebPrintf(client, "  var tmpAry = new Array();\n");
-  WebPrintf(client, "  for (var i=0;i<selElem.options.length;i++) {\n");
-  WebPrintf(client, "      tmpAry[i] = new Array();\n");
-  WebPrintf(client, "      tmpAry[i][0] = selElem.options[i].text;\n");
-  WebPrintf(client, "      tmpAry[i][1] = selElem.options[i].value;\n");
-  WebPrintf(client, "  }\n");
-  WebPrintf(client, "  tmpAry.sort();\n");
-  WebPrintf(client, "  while (selElem.options.length > 0) {\n");
-  WebPrintf(client, "      selElem.options[0] = null;\n");
-  WebPrintf(client, "  }\n");
-  WebPrintf(client, "  var toSel = 2;\n");
-  WebPrintf(client, "  for (var i=0;i<tmpAry.length;i++) {\n");
-  WebPrintf(client, "      var op = new Option(tmpAry[i][0], tmpAry[i][1]);\n");
-  WebPrintf(client, "      selElem.options[i] = op;\n");
-  WebPrintf(client, "  }\n");
-  WebPrintf(client, "  return;\n");
-  WebPrintf(client, "}\n");
-  WebPrintf(client, "sortSelect(document.getElementById('tz'));\n");
-  WebPrintf(client, "function selectItemByValue(elmnt, value) {\n");
-  WebPrintf(client, "  for(var i=0; i < elmnt.options.length; i++) {\n");
-  WebPrintf(client, "    if(elmnt.options[i].value === value) { elmnt.selectedIndex = i; break; }\n");
-  WebPrintf(client, "  }\n");
-  WebPrintf(client, "}\n");
-  WebPrintf(client, "setTimeout(function(){selectItemByValue(document.getElementById('tz'), '%s');}, 500);\n", timezone );
-  WebPrintf(client, "</script>\n");
-}
-
-
-
-
-
-// Scan an integer from a string, place it into dest, and then return # of bytes scanned
-int ParseInt(char *src, int *dest)
-{
-  byte count = 0;
-  bool neg = false;
-  int res = 0;
-  if (!src) return 0;
-  if (src[0] == '-') {neg = true; src++; count++;}
-  while (*src && (*src>='0') && (*src<='9')) {
-    res = res * 10;
-    res += *src - '0';
-    src++;
-    count++;
-  }
-  if (neg) res *= -1;
-  if (dest) *dest = res;
-  return count;
-}
-
-void Read4Int(char *str, byte *p)
-{
-  int i;
-  str += ParseInt(str, &i); p[0] = i; if (*str) str++;
-  str += ParseInt(str, &i); p[1] = i; if (*str) str++;
-  str += ParseInt(str, &i); p[2] = i; if (*str) str++;
-  str += ParseInt(str, &i); p[3] = i;
+}
+
+// Copy out the static file with this path, false if there isn't one
+static bool WebFindStatic(const char *url, WebStatic *file)
+{
+  uint32_t hash = WebHashStr(url);
+  for (unsigned int i=0; i<sizeof(webStatic)/sizeof(webStatic[0]); i++) {
+    memcpy_P(file, &webStatic[i], sizeof(*file));
+    if (file->hash == hash && !strcmp_P(url, file->path)) return true;
+  }
+  return false;
+}
+
+uint32_t WebStaticTag(const char *url)
+{
+  WebStatic file;
+  return WebFindStatic(url, &file) ? file.tag : 0;
+}
+
+// Static files go out in one piece straight from flash
+bool WebSendStatic(WebWriter *client, const char *url)
+{
+  WebStatic file;
+  if (WebFindStatic(url, &file)) {
+
+    // Only changes with a firmware update
+    char etag[12];
+    snprintf_P(etag, sizeof(etag), PSTR("\"%08lx\""), (unsigned long)file.tag);
+    if (WebCheckETag(client, etag, WEB_STATIC_MAXAGE)) return true;
+
+    bool gz = client->gzipOK();
+    char type[32];
+    strlcpy_P(type, file.type, sizeof(type));
+    WebPrintf(client, "HTTP/1.1 200 OK\r\n");
+    WebPrintf(client, "Server: PsychoPlug\r\n");
+    WebPrintf(client, "Content-type: %s\r\n", type);
+    if (gz) WebPrintf(client, "Content-Encoding: gzip\r\n");
+    WebPrintf(client, "Vary: Accept-Encoding\r\n");
+    WebCacheHeaders(client, WEB_STATIC_MAXAGE);
+    WebConnectionHeaders(client);
+    WebPrintf(client, "\r\n");
+    client->beginBody();
+    if (gz) client->write_P((PGM_P)file.gzData, file.gzLen);
+    else client->write_P((PGM_P)file.data, file.len);
+    return true;
+  }
+  return false;
 }
@@ -21,10 +21,82 @@
 #ifndef _web_h
 #define _web_h
 
-// Global way of writing out dynamic HTML to socket
-// snprintf guarantees a null termination
-#define WebPrintf(c, fmt, ...) { char webBuff[192]; snprintf_P(webBuff, sizeof(webBuff), PSTR(fmt), ## __VA_ARGS__); (c)->print(webBuff); delay(10);}
-#define WebPrintfPSTR(c, fmt, ...) { char webBuff[192]; snprintf_P(webBuff, sizeof(webBuff), (fmt), ## __VA_ARGS__); (c)->print(webBuff); delay(10);}
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include "session.h"
+#include "form.h"
+
+// Size of each response buffer.  One full buffer goes out as a single TCP
+// segment (and a single TLS record on HTTPS), so keep it under the MSS with
+// enough left over for the TLS record header, MAC and padding.
+#define WEBWRITER_BUFFLEN (1400)
+// Number of response buffers shared by all connections
+#define WEBWRITER_POOL (2)
+
+// How long browsers may keep static files without asking again; pages
+// link them as "file?v=<tag>" so a firmware update changes the URL
+#define WEB_STATIC_MAXAGE (7L * 24L * 60L * 60L)
+
+// Persistent connection limits: idle time before we hang up and requests served per connection
+#define WEB_KEEPALIVE_MS (5000)
+#define WEB_KEEPALIVE_MAXREQ (50)
+
+// Shortest time between new sessions, a burst of password logins shares the first one's
+#define WEB_SESSION_NEW_MS (5000)
+
+// Buffered response writer.  Output accumulates in a pooled buffer and is only
+// sent to the client when the buffer fills or the response is done (flush() or
+// destruction).  If the pool is exhausted it falls back to writing straight
+// through to the socket.  On keep-alive connections the body is sent with
+// chunked transfer encoding, one chunk per buffer.
+class WebWriter : public Print
+{
+public:
+  WebWriter(WiFiClient *client);
+  virtual ~WebWriter();
+
+  using Print::write;
+  virtual size_t write(uint8_t c);
+  virtual size_t write(const uint8_t *data, size_t len);
+  size_t write_P(PGM_P data, size_t len);
+  size_t printf_P(PGM_P fmt, ...);
+  virtual void flush(); // Send anything pending to the client
+  void end(); // Finish the response, called automatically on destruction
+
+  void setKeepAlive(bool keepAlive) { _keepAlive = keepAlive; }
+  bool keepAlive() { return _keepAlive; }
+  void beginBody(); // Headers are done, start chunking if needed
+  void setSession(const char *token) { _session = token; } // Hand out a session cookie in the headers
+  const char *session() { return _session; }
+  void setGzipOK(bool gzipOK) { _gzipOK = gzipOK; } // Client takes gzip Content-Encoding
+  bool gzipOK() { return _gzipOK; }
+  void setIfNoneMatch(const char *etag) { _ifNoneMatch = etag; } // ETag the client already has
+  const char *ifNoneMatch() { return _ifNoneMatch; }
+  void setETag(const char *etag) { strlcpy(_etag, etag, sizeof(_etag)); } // Tag for this response, "" for none
+  const char *etag() { return _etag; }
+
+  WiFiClient *client() { return _client; }
+
+private:
+  size_t limit();
+  void closeChunk();
+  size_t writeDirect(const uint8_t *data, size_t len, bool pmem);
+
+  WiFiClient *_client;
+  char *_buff;
+  size_t _len;
+  bool _keepAlive;
+  bool _chunked;
+  size_t _chunkStart;
+  const char *_session;
+  bool _gzipOK;
+  const char *_ifNoneMatch;
+  char _etag[20];
+};
+
+// Global way of writing out dynamic HTML to a WebWriter
+#define WebPrintf(c, fmt, ...) { (c)->printf_P(PSTR(fmt), ## __VA_ARGS__); }
+#define WebPrintfPSTR(c, fmt, ...) { (c)->printf_P((fmt), ## __VA_ARGS__); }
 
 // Common HTTP header bits
 #define DOCTYPE "<!DOCTYPE HTML PUBLIC \"-//W3C//DTD HTML 4.01 Transitional//EN\" \"http://www.w3.org/TR/html4/loose.dtd\">"
@@ -32,33 +104,151 @@
 
 
 // Web header creation
-void WebPrintError(WiFiClient *client, int code); // Sends only the error code string and a description
-void WebError(WiFiClient *client, int code, const char *headers, bool usePMEM = true); // Sends whole HTTP error headers
-void WebHeaders(WiFiClient *client, PGM_P /*const char **/headers); // Send success headers
+void WebPrintError(WebWriter *client, int code); // Sends only the error code string and a description
+void WebError(WebWriter *client, int code, const char *headers, bool usePMEM = true); // Sends whole HTTP error headers
+void WebHeaders(WebWriter *client, PGM_P /*const char **/headers); // Send success headers
+void WebConnectionHeaders(WebWriter *client); // Connection/framing headers for keep-alive or close
+void WebJSONHeaders(WebWriter *client, int code); // Headers for a JSON API response with the given status
+void WebJSONString(WebWriter *client, const char *str); // Write a quoted, escaped JSON string
+bool WebNotModified(WebWriter *client, uint32_t version); // ETag the response, or send a 304 and return true if the client has this version
+
+// Per-connection HTTP request parser state.  WebReadRequest() consumes whatever
+// bytes have arrived and returns right away, so a slow client never stalls loop()
+#define WEB_REQUEST_TIMEOUT_MS (5000) // Max time to wait for a whole request
+#define WEB_RXBUFF (256) // Longest request or header line, longer headers are skipped
+
+typedef struct {
+  byte state;
+  bool connClose;
+  bool skipLine; // Throwing away the rest of an overlong header line
+  bool tooLong; // Request line or body didn't fit, will get an error
+  bool gzipOK; // Accept-Encoding includes gzip
+  bool streamForm; // Body goes through form instead of into reqBuff
+  bool newSession; // Authenticated by password, sessBuff now holds a new token to hand out
+  bool takesCookies; // Sent a Cookie header or asked for an HTML page, so can return a session
+  bool keepAlive; // Client can keep the connection open
+  int rxLen; // Bytes waiting in rxBuff
+  int reqLen;
+  int bodyOff; // Start of the POST body in reqBuff
+  long bodyLeft; // Content-Length bytes not yet received
+  unsigned long startMS;
+  unsigned long lastByteMS;
+  char rxBuff[WEB_RXBUFF]; // Socket data is read in bulk here and headers tokenized in place
+  char reqBuff[384]; // Request line, followed by the POST body
+  char authBuff[128]; // Basic credentials, still Base64 encoded
+  char sessBuff[SESSION_TOKENHEX + 1]; // Session token from a cookie or bearer header
+  char etag[24]; // If-None-Match
+  char *url; // Decoded path, once the headers are in
+  char *params; // Query string or buffered POST body
+  FormParser form;
+} WebRequest;
 
-// Web decoding utilities
-void Base64Decode(char *str); // In-place B64 decode
-void URLDecode(char *ptr); // In-place URL decode
+// WebReadRequest() results
+#define WEBREQ_PENDING (0) // Need more data, call again later
+#define WEBREQ_READY   (1) // Request complete, url and params are valid
+#define WEBREQ_FAILED  (2) // Timed out or an error was sent back, start over or hang up
+#define WEBREQ_HEADERS (3) // Headers are in and url is valid, route it and call again for the body
+
+// Table driven request dispatch.  Paths are FNV-1a hashed at compile time and
+// the table lives in flash.  WebRoutesBegin() builds a small RAM hash index
+// over it so a lookup costs one pass over the URL and usually a single probe.
+// The path stays in flash too and is only compared once the hash matches.
+typedef void (*WebHandler)(WebWriter *out, char *url, char *params);
+
+typedef struct {
+  uint32_t hash;
+  PGM_P path; // NULL for catch-alls
+  byte servers; // Which WEB_SERVER_xxx this route answers on
+  byte flags;
+  WebHandler handler;
+  FormHandler field; // If set, POST bodies are streamed through this a field at a time
+} WebRoute;
+
+// Servers, a request arrives on exactly one of these
+#define WEB_SERVER_REDIRECT (0x01) // HTTP, once configured
+#define WEB_SERVER_CAPTIVE  (0x02) // HTTP, setup AP mode
+#define WEB_SERVER_SETUP    (0x04) // HTTPS, setup AP mode
+#define WEB_SERVER_MAIN     (0x08) // HTTPS, once configured
+
+// Route flags
+#define ROUTE_GET     (0x01)
+#define ROUTE_POST    (0x02)
+#define ROUTE_ANY     (ROUTE_GET | ROUTE_POST)
+#define ROUTE_AUTH    (0x04) // Needs the web UI user and password
+#define ROUTE_PARAMS  (0x08) // 404 unless some form parameters were given
+#define ROUTE_STREAM  (0x10) // May keep the connection as an event stream
+#define ROUTE_DEFAULT (0x80) // Catch-all for its servers when no path matches, hash unused
+
+// Results of WebFindRoute()
+#define WEBROUTE_FOUND     (0)
+#define WEBROUTE_NOTFOUND  (1)
+#define WEBROUTE_BADMETHOD (2)
+
+constexpr uint32_t WebHash(const char *str, uint32_t hash = 2166136261UL)
+{
+  return *str ? WebHash(str + 1, (hash ^ (uint8_t)*str) * 16777619UL) : hash;
+}
+// Paths are constexpr PROGMEM arrays so they can be hashed at compile time, i.e.
+//   static constexpr char pathIndex[] PROGMEM = "index.html";
+#define ROUTE(path, servers, flags, handler) { WebHash(path), (path), (servers), (flags), (handler), NULL }
+#define ROUTE_FORM(path, servers, flags, field, handler) { WebHash(path), (path), (servers), (flags), (handler), (field) }
+#define ROUTE_CATCHALL(servers, flags, handler) { 0, NULL, (servers), (flags) | ROUTE_DEFAULT, (handler), NULL }
+
+// One client connection: the socket, its parser and some latency bookkeeping
+typedef struct {
+  WiFiClient *client; // NULL when the slot is free
+  bool secure; // Accepted on the HTTPS server
+  int requests; // Served on this connection
+  bool streaming; // Handed to the event stream, no more requests are read
+  WebRequest req;
+  WebRoute route; // Where the current request is going
+  unsigned long served; // Requests served on this slot, ever
+  unsigned long totalMS; // Sum of first byte to response done times
+  unsigned long maxMS;
+} WebConn;
+
+// Request latency histogram, bucket N counts requests taking < 2^(N+1) ms
+#define WEB_LATENCY_BUCKETS (14)
+
+void WebConnOpen(WebConn *conn, WiFiClient *client, bool secure);
+void WebConnClose(WebConn *conn);
+void WebConnServed(WebConn *conn); // Response done, record its latency
+unsigned long WebLatencyPercentile(int pct); // Upper bound in ms of the given percentile
 
 // GET/POST parsing
-bool WebReadRequest(WiFiClient *client, char **urlStr, char **paramStr, bool authReq, const char *uiUser = NULL, const char *uiSalt = NULL, const char *uiPassEnc= NULL); // Parse HTTP request, ensure authentication passes
-bool ParseParam(char **paramStr, char **name, char **value); // Get next name/parameter from a param string
-bool IsIndexHTML(const char *url); // Is this meant to be index.html (/, index.htm, etc.)
+void WebRequestBegin(WebRequest *req); // Reset for a new request on this connection
+bool WebRequestIdle(WebRequest *req); // Nothing received yet for the next request
+bool WebRequestPost(WebRequest *req); // Request (still in the parser's buffer) is a POST
+void WebRequestForm(WebRequest *req, FormHandler handler); // After WEBREQ_HEADERS, stream a POST body through handler
+int WebReadRequest(WiFiClient *client, WebRequest *req, char **urlStr, char **paramStr, bool *keepAlive); // Parse HTTP request
+bool WebAuthenticate(WebWriter *out, WebRequest *req, const char *uiUser, const char *uiSalt, const char *uiPassEnc); // Check session or credentials, send a 401 if they fail
+void WebAuthStats(unsigned long *basicCount, unsigned long *basicUS, unsigned long *sessCount, unsigned long *sessUS); // Time spent checking each way
+void WebSessionStats(unsigned long *created, unsigned long *reused); // Sessions handed out vs. logins they saved
+
+// Static files from static/, built into flash by make-static-h.pl
+typedef struct {
+  uint32_t hash; // WebHash() of the path
+  PGM_P path; // Compared once the hash matches
+  PGM_P type; // Content-type
+  const uint8_t *data; // PROGMEM
+  uint16_t len;
+  const uint8_t *gzData; // PROGMEM, the same gzipped
+  uint16_t gzLen;
+  uint32_t tag; // Changes with the contents, for the ETag
+} WebStatic;
+
+bool WebSendStatic(WebWriter *client, const char *url); // Send a static file, gzipped if the client allows, false if there's none
+uint32_t WebStaticTag(const char *url); // Content tag of a static file for versioned URLs, 0 if there's none
+
+void WebRoutesBegin(const WebRoute *routes /* PROGMEM */, int count);
+int WebFindRoute(const char *url, byte server, bool post, WebRoute *route); // Copies out the matching (or catch-all) route
 
 // HTML FORM generation
-void WebFormText(WiFiClient *client, /*const char **/ PGM_P label, const char *name, const char *value, bool enabled);
-void WebFormText(WiFiClient *client, /*const char **/ PGM_P label, const char *name, const int value, bool enabled);
-void WebFormCheckbox(WiFiClient *client, /*const char **/ PGM_P label, const char *name, bool checked, bool enabled);
-void WebFormCheckboxDisabler(WiFiClient *client, PGM_P /*const char **/label, const char *name, bool invert, bool checked, bool enabled, const char *ids[]);
-void WebTimezonePicker(WiFiClient *client, const char *timezone);
-
-// HTML FORM parsing
-int ParseInt(char *src, int *dest);
-void Read4Int(char *str, byte *p);
-#define ParamText(name, dest)     { if (!strcmp(namePtr, (name))) strlcpy((dest), valPtr, sizeof(dest)); }
-#define ParamCheckbox(name, dest) { if (!strcmp(namePtr, (name))) (dest) = !strcmp("on", valPtr); }
-#define ParamInt(name, dest)      { if (!strcmp(namePtr, (name))) ParseInt(valPtr, &dest); }
-#define Param4Int(name, dest)     { if (!strcmp(namePtr, (name))) Read4Int(valPtr, (dest)); }
+void WebFormText(WebWriter *client, /*const char **/ PGM_P label, const char *name, const char *value, bool enabled);
+void WebFormText(WebWriter *client, /*const char **/ PGM_P label, const char *name, const int value, bool enabled);
+void WebFormCheckbox(WebWriter *client, /*const char **/ PGM_P label, const char *name, bool checked, bool enabled);
+void WebFormCheckboxDisabler(WebWriter *client, PGM_P /*const char **/label, const char *name, bool invert, bool checked, bool enabled, const char *ids[]);
+void WebTimezonePicker(WebWriter *client, const char *timezone);
 
 
 #endif